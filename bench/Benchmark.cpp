@@ -0,0 +1,574 @@
+#define GL_SILENCE_DEPRECATION
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "BatchRenderer.h"
+#include "DeletionQueue.h"
+#include "FrameBuffer.h"
+#include "FrameUniforms.h"
+#include "GLState.h"
+#include "HeadlessContext.h"
+#include "IndexBuffer.h"
+#include "MeshOptimizer.h"
+#include "ProgramCache.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "ShaderLibrary.h"
+#include "Texture.h"
+#include "UniformRing.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "VertexBufferLayout.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+// Renderer micro-benchmarks, printed as one JSON document on stdout.
+// Runs headless by default so it works on software GL (llvmpipe) in CI,
+// pass --window to use a hidden GLFW window instead. Run from the
+// repository root so res/ can be found.
+
+using Clock = std::chrono::steady_clock;
+
+// Every measurement runs at least this long
+static const double s_MinSeconds = 0.2;
+
+// Small target, on software GL filling 640x480 would hide everything else
+static const int s_TargetSize = 64;
+
+struct Result {
+    std::string Name;
+    unsigned int Batch;
+    double Value;
+    const char* Unit;
+    // Extra "key": value pairs, already formatted
+    std::string Extra;
+};
+
+static std::vector<Result> s_Results;
+
+// Seconds one call of body takes. The iteration count doubles until the
+// whole run takes long enough to trust, glFinish makes sure the GPU side
+// of the work is included.
+static double TimePerIteration(const std::function<void()>& body) {
+    body();
+    glFinish();
+
+    for (unsigned int iterations = 1;; iterations *= 2) {
+        auto start = Clock::now();
+        for (unsigned int i = 0; i < iterations; ++i) body();
+        glFinish();
+        GLCheckpoint("benchmark");
+        DeletionQueue::Get().Collect();
+        std::chrono::duration<double> elapsed = Clock::now() - start;
+        if (elapsed.count() >= s_MinSeconds)
+            return elapsed.count() / iterations;
+    }
+}
+
+// GL binds one more run of body issues and skips, as JSON fields. Counted
+// apart from the timing, which runs body an unknown number of times.
+static std::string CountBinds(const std::function<void()>& body) {
+    GLState::Get().ResetStats();
+    body();
+    const GLState::Stats& stats = GLState::Get().GetStats();
+    return "\"binds_issued\": " + std::to_string(stats.Issued) +
+           ", \"binds_skipped\": " + std::to_string(stats.Skipped);
+}
+
+// A size x size grid of quads filling clip space, 2 * size^2 triangles.
+// Vertices are x, y, u, v.
+static void BuildGrid(unsigned int size, std::vector<float>& vertices,
+                      std::vector<unsigned int>& indices) {
+    for (unsigned int y = 0; y <= size; ++y) {
+        for (unsigned int x = 0; x <= size; ++x) {
+            float u = (float)x / size, v = (float)y / size;
+            vertices.insert(vertices.end(),
+                            {u * 2.0f - 1.0f, v * 2.0f - 1.0f, u, v});
+        }
+    }
+    for (unsigned int y = 0; y < size; ++y) {
+        for (unsigned int x = 0; x < size; ++x) {
+            unsigned int i = y * (size + 1) + x;
+            indices.insert(indices.end(), {i, i + 1, i + size + 2,
+                                           i + size + 2, i + size + 1, i});
+        }
+    }
+}
+
+struct Grid {
+    std::unique_ptr<VertexArray> va;
+    std::unique_ptr<VertexBuffer> vb;
+    std::unique_ptr<IndexBuffer> ib;
+
+    Grid(unsigned int size) {
+        std::vector<float> vertices;
+        std::vector<unsigned int> indices;
+        BuildGrid(size, vertices, indices);
+        Upload(vertices, indices);
+    }
+
+    Grid(const std::vector<float>& vertices,
+         const std::vector<unsigned int>& indices) {
+        Upload(vertices, indices);
+    }
+
+    void Upload(const std::vector<float>& vertices,
+                const std::vector<unsigned int>& indices) {
+        va = std::make_unique<VertexArray>();
+        vb = std::make_unique<VertexBuffer>(vertices.data(),
+                                            vertices.size() * sizeof(float));
+        VertexBufferLayout layout;
+        layout.Push<float>(2);
+        layout.Push<float>(2);
+        va->AddBuffer(*vb, layout);
+        ib = std::make_unique<IndexBuffer>(indices.data(), indices.size());
+        va->Unbind();
+    }
+
+    unsigned int GetTriangles() const { return ib->GetCount() / 3; }
+};
+
+static void BenchDraws(Shader& shader, FrameUniforms& frame) {
+    Grid quad(1);
+    Renderer renderer;
+
+    // Shrink the quad to a pixel, this is about per-draw cost, not fill
+    CameraData camera;
+    camera.ViewProjection =
+        glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / s_TargetSize));
+    frame.SetCamera(camera);
+
+    const unsigned int batches[] = {1, 100, 10000};
+    for (unsigned int draws : batches) {
+        auto body = [&] {
+            for (unsigned int i = 0; i < draws; ++i)
+                renderer.Draw(*quad.va, *quad.ib, shader);
+        };
+        double seconds = TimePerIteration(body);
+        s_Results.push_back(
+            {"draws", draws, draws / seconds, "draws/s", CountBinds(body)});
+    }
+
+    frame.SetCamera(CameraData());
+}
+
+// Draws submitted in an order that switches shader, texture and vertex
+// array every time, Flush sorts them back into groups
+static void BenchRenderQueue(FrameUniforms& frame) {
+    Grid quads[2] = {Grid(1), Grid(1)};
+    Shader shaders[2] = {Shader("res/shaders/Basic.shader"),
+                         Shader("res/shaders/Basic.shader", {{"TINT", "1"}})};
+    const unsigned int pixels[3] = {0xff0000ff, 0xff00ff00, 0xffff0000};
+    std::vector<std::unique_ptr<Texture>> textures;
+    for (const unsigned int& pixel : pixels)
+        textures.push_back(std::make_unique<Texture>(1, 1, &pixel));
+    Renderer renderer;
+
+    CameraData camera;
+    camera.ViewProjection =
+        glm::scale(glm::mat4(1.0f), glm::vec3(1.0f / s_TargetSize));
+    frame.SetCamera(camera);
+
+    const unsigned int batches[] = {100, 10000};
+    for (unsigned int draws : batches) {
+        auto body = [&] {
+            for (unsigned int i = 0; i < draws; ++i) {
+                const Grid& quad = quads[i % 2];
+                renderer.Submit(*quad.va, *quad.ib, shaders[i / 2 % 2],
+                                textures[i % 3].get(), (float)i / draws);
+            }
+            renderer.Flush();
+        };
+        double seconds = TimePerIteration(body);
+        std::string binds = CountBinds(body);
+        const RenderQueueStats& stats = renderer.GetQueueStats();
+        char extra[128];
+        snprintf(extra, sizeof(extra),
+                 "\"state_changes_unsorted\": %u, "
+                 "\"state_changes_sorted\": %u, \"state_changes_saved\": %d",
+                 stats.StateChangesUnsorted, stats.StateChangesSorted,
+                 stats.Saved());
+        s_Results.push_back({"render_queue", draws, draws / seconds,
+                             "draws/s", std::string(extra) + ", " + binds});
+    }
+
+    frame.SetCamera(CameraData());
+}
+
+// Every draw gets its own transform and color, through glUniform calls or
+// through a slot of a UniformRing bound with glBindBufferRange
+static void BenchObjectUniforms() {
+    Grid quad(1);
+    Renderer renderer;
+    const unsigned int batches[] = {100, 10000};
+
+    // One pixel quads scattered over the target, as in BenchDraws
+    auto model = [](unsigned int i) {
+        glm::vec3 offset((float)(i % 7) * 0.25f - 0.75f,
+                         (float)(i % 5) * 0.25f - 0.5f, 0.0f);
+        return glm::scale(glm::translate(glm::mat4(1.0f), offset),
+                          glm::vec3(1.0f / s_TargetSize));
+    };
+    const glm::vec4 color(1.0f, 0.5f, 0.25f, 1.0f);
+
+    Shader plain("res/shaders/Object.shader", {{"PLAIN_UNIFORMS", "1"}});
+    UniformHandle modelUniform = plain.GetUniform("u_Model");
+    UniformHandle colorUniform = plain.GetUniform("u_ObjectColor");
+    for (unsigned int draws : batches) {
+        auto body = [&] {
+            plain.Bind();
+            for (unsigned int i = 0; i < draws; ++i) {
+                plain.SetUniformMat4f(modelUniform, model(i));
+                plain.SetUniform4f(colorUniform, color.r, color.g, color.b,
+                                   color.a);
+                renderer.Draw(*quad.va, *quad.ib, plain);
+            }
+        };
+        double seconds = TimePerIteration(body);
+        s_Results.push_back({"object_uniforms", draws, draws / seconds,
+                             "draws/s", CountBinds(body)});
+    }
+
+    Shader blocks("res/shaders/Object.shader");
+    Std140Writer size(nullptr, 0);
+    size.Write(glm::mat4());
+    size.Write(glm::vec4());
+    UniformRing objects("Object", size.GetSize(), batches[1]);
+    for (unsigned int draws : batches) {
+        auto body = [&] {
+            blocks.Bind();
+            for (unsigned int i = 0; i < draws; ++i) {
+                UniformRing::Slot slot = objects.Allocate();
+                slot.Writer.Write(model(i));
+                slot.Writer.Write(color);
+                objects.Bind(slot);
+                renderer.Draw(*quad.va, *quad.ib, blocks);
+            }
+            objects.EndFrame();
+        };
+        double seconds = TimePerIteration(body);
+        std::string binds = CountBinds(body);
+        s_Results.push_back(
+            {"object_blocks", draws, draws / seconds, "draws/s",
+             "\"stalls\": " + std::to_string(objects.GetStats().Stalls) +
+                 ", " + binds});
+    }
+}
+
+static void BenchTriangles(Shader& shader) {
+    Renderer renderer;
+
+    // Grid sizes, 2 * size^2 triangles in a single draw
+    const unsigned int sizes[] = {1, 16, 256};
+    for (unsigned int size : sizes) {
+        Grid grid(size);
+        double seconds = TimePerIteration(
+            [&] { renderer.Draw(*grid.va, *grid.ib, shader); });
+        s_Results.push_back({"triangles", grid.GetTriangles(),
+                             grid.GetTriangles() / seconds, "triangles/s",
+                             ""});
+    }
+}
+
+// The same grid with its triangles shuffled, the way an exporter that
+// knows nothing about vertex caches may leave them, then optimized
+static void BenchMeshOptimizer(Shader& shader) {
+    const unsigned int size = 128;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    BuildGrid(size, vertices, indices);
+    unsigned int vertexCount = vertices.size() / 4;
+
+    std::vector<unsigned int> triangles(indices.size() / 3);
+    for (unsigned int i = 0; i < triangles.size(); ++i) triangles[i] = i;
+    std::shuffle(triangles.begin(), triangles.end(), std::mt19937(1));
+    std::vector<unsigned int> shuffled;
+    for (unsigned int t : triangles)
+        shuffled.insert(shuffled.end(), indices.begin() + t * 3,
+                        indices.begin() + t * 3 + 3);
+
+    // The grid is flat, x and y with z = 0, which is all the overdraw pass
+    // needs to run; what it costs in vertex cache efficiency is the
+    // difference between acmr_cache and the final acmr
+    std::vector<float> positions;
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        positions.insert(positions.end(),
+                         {vertices[v * 4 + 0], vertices[v * 4 + 1], 0.0f});
+
+    std::vector<unsigned int> optimized = shuffled;
+    std::vector<float> optimizedVertices = vertices;
+    auto start = Clock::now();
+    OptimizeVertexCache(optimized, vertexCount);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    float cacheACMR = AnalyzeVertexCache(optimized, vertexCount).ACMR;
+    start = Clock::now();
+    OptimizeOverdraw(optimized, positions.data(), 3 * sizeof(float),
+                     vertexCount);
+    OptimizeVertexFetch(optimized, optimizedVertices.data(), vertexCount,
+                        4 * sizeof(float));
+    elapsed += Clock::now() - start;
+
+    VertexCacheStats before = AnalyzeVertexCache(shuffled, vertexCount);
+    VertexCacheStats after = AnalyzeVertexCache(optimized, vertexCount);
+    unsigned int triangleCount = triangles.size();
+    char extra[192];
+    snprintf(extra, sizeof(extra),
+             "\"acmr_before\": %.3f, \"atvr_before\": %.3f, "
+             "\"acmr_cache\": %.3f, \"atvr\": %.3f, \"optimize_ms\": %.3f",
+             before.ACMR, before.ATVR, cacheACMR, after.ATVR,
+             elapsed.count() * 1000.0);
+    s_Results.push_back(
+        {"vertex_cache", triangleCount, after.ACMR, "acmr", extra});
+
+    Renderer renderer;
+    Grid unoptimizedGrid(vertices, shuffled);
+    Grid optimizedGrid(optimizedVertices, optimized);
+    double seconds = TimePerIteration([&] {
+        renderer.Draw(*unoptimizedGrid.va, *unoptimizedGrid.ib, shader);
+    });
+    s_Results.push_back({"triangles_unoptimized", triangleCount,
+                         triangleCount / seconds, "triangles/s", ""});
+    seconds = TimePerIteration([&] {
+        renderer.Draw(*optimizedGrid.va, *optimizedGrid.ib, shader);
+    });
+    s_Results.push_back({"triangles_optimized", triangleCount,
+                         triangleCount / seconds, "triangles/s", ""});
+}
+
+static void BenchUniforms() {
+    // Tinted, so u_Color is live and every update reaches the driver
+    Shader shader("res/shaders/Basic.shader", {{"TINT", "1"}});
+    shader.Bind();
+    UniformHandle color = shader.GetUniform("u_Color");
+
+    const unsigned int batches[] = {1, 100, 10000};
+    for (unsigned int updates : batches) {
+        double seconds = TimePerIteration([&] {
+            for (unsigned int i = 0; i < updates; ++i)
+                shader.SetUniform4f("u_Color", (float)i, 0.0f, 0.0f, 1.0f);
+        });
+        s_Results.push_back(
+            {"uniform_updates", updates, updates / seconds, "updates/s", ""});
+
+        seconds = TimePerIteration([&] {
+            for (unsigned int i = 0; i < updates; ++i)
+                shader.SetUniform4f(color, (float)i, 0.0f, 0.0f, 1.0f);
+        });
+        s_Results.push_back({"uniform_updates_handle", updates,
+                             updates / seconds, "updates/s", ""});
+    }
+}
+
+static void BenchTextureUploads() {
+    const int sizes[] = {64, 256, 1024, 2048};
+    for (int size : sizes) {
+        std::vector<unsigned char> pixels(size * size * 4, 0x80);
+        Texture texture(size, size, nullptr);
+        double seconds =
+            TimePerIteration([&] { texture.SetData(pixels.data()); });
+        double megabytes = pixels.size() / (1024.0 * 1024.0);
+        s_Results.push_back({"texture_upload", (unsigned int)size,
+                             megabytes / seconds, "MB/s", ""});
+    }
+}
+
+static void BenchShaderCompile() {
+    // Always from source, the cache has its own benchmark
+    ProgramCache::Get().SetEnabled(false);
+    const unsigned int batches[] = {1, 10};
+    for (unsigned int count : batches) {
+        double seconds = TimePerIteration([&] {
+            for (unsigned int i = 0; i < count; ++i)
+                Shader shader("res/shaders/Basic.shader");
+        });
+        s_Results.push_back({"shader_compile_link", count,
+                             seconds * 1000.0 / count, "ms/shader", ""});
+    }
+    ProgramCache::Get().SetEnabled(true);
+}
+
+// Startup cost of one shader with the program binary cache. Cold compiles
+// and stores the binary, warm loads it back. Without binary formats both
+// just compile.
+static void BenchShaderCache() {
+    ProgramCache& cache = ProgramCache::Get();
+    std::string extra = std::string("\"supported\": ") +
+                        (ProgramCache::IsSupported() ? "true" : "false");
+
+    double cold = TimePerIteration([&] {
+        cache.Clear();
+        Shader shader("res/shaders/Basic.shader");
+    });
+    double warm =
+        TimePerIteration([&] { Shader shader("res/shaders/Basic.shader"); });
+    cache.Clear();
+
+    s_Results.push_back(
+        {"shader_cache_cold", 1, cold * 1000.0, "ms/shader", extra});
+    s_Results.push_back(
+        {"shader_cache_warm", 1, warm * 1000.0, "ms/shader", extra});
+}
+
+// Looking up variants that already exist, which is all a frame should do.
+// Building them happens in the untimed first call and is reported as extra.
+static void BenchShaderVariants() {
+    ProgramCache::Get().SetEnabled(false);
+    ShaderLibrary library;
+    const ShaderDefines variants[] = {{}, {{"TINT", "1"}}};
+    const unsigned int count = sizeof(variants) / sizeof(variants[0]);
+
+    double seconds = TimePerIteration([&] {
+        for (const ShaderDefines& defines : variants)
+            library.Get("res/shaders/Basic.shader", defines);
+    });
+    ProgramCache::Get().SetEnabled(true);
+
+    const ShaderLibrary::Stats& stats = library.GetStats();
+    char extra[96];
+    snprintf(extra, sizeof(extra),
+             "\"variants\": %u, \"compile_ms_per_variant\": %.3f",
+             stats.Variants, stats.CompileSeconds * 1000.0 / stats.Variants);
+    s_Results.push_back({"shader_variant_lookup", count,
+                         seconds * 1e6 / count, "us/lookup", extra});
+}
+
+static void BenchBatchRenderer(FrameUniforms& frame) {
+    const unsigned int pixels[4] = {0xff0000ff, 0xff00ff00, 0xffff0000,
+                                    0xffffffff};
+    std::vector<std::unique_ptr<Texture>> textures;
+    for (const unsigned int& pixel : pixels)
+        textures.push_back(std::make_unique<Texture>(1, 1, &pixel));
+
+    Shader shader("res/shaders/Batch.shader");
+    BatchRenderer batch(shader);
+    CameraData camera;
+    camera.ViewProjection =
+        glm::ortho(-200.0f, 200.0f, -150.0f, 150.0f, -1.0f, 1.0f);
+    frame.SetCamera(camera);
+
+    const unsigned int batches[] = {1000, 10000, 100000};
+    for (unsigned int quads : batches) {
+        double seconds = TimePerIteration([&] {
+            batch.ResetStats();
+            batch.Begin();
+            for (unsigned int i = 0; i < quads; ++i) {
+                glm::vec2 position((float)(i % 400) - 200.0f,
+                                   (float)(i / 400 % 300) - 150.0f);
+                batch.DrawQuad(position, glm::vec2(1.0f),
+                               *textures[i % textures.size()]);
+            }
+            batch.End();
+        });
+        s_Results.push_back(
+            {"batch_quads", quads, quads / seconds, "quads/s",
+             "\"draw_calls\": " + std::to_string(batch.GetStats().DrawCalls)});
+    }
+
+    frame.SetCamera(CameraData());
+}
+
+static void PrintJSON() {
+    printf("{\n");
+    printf("  \"renderer\": \"%s\",\n", glGetString(GL_RENDERER));
+    printf("  \"version\": \"%s\",\n", glGetString(GL_VERSION));
+    printf("  \"gl_check_mode\": %d,\n", GL_CHECK_MODE);
+    printf("  \"results\": [\n");
+    for (size_t i = 0; i < s_Results.size(); ++i) {
+        const Result& result = s_Results[i];
+        printf("    {\"name\": \"%s\", \"batch\": %u, \"value\": %.3f, "
+               "\"unit\": \"%s\"%s%s}%s\n",
+               result.Name.c_str(), result.Batch, result.Value, result.Unit,
+               result.Extra.empty() ? "" : ", ", result.Extra.c_str(),
+               i + 1 < s_Results.size() ? "," : "");
+    }
+    printf("  ]\n}\n");
+}
+
+static GLFWwindow* CreateHiddenWindow() {
+    if (!glfwInit()) return nullptr;
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+    GLFWwindow* window = glfwCreateWindow(640, 480, "Benchmark", NULL, NULL);
+    if (!window) return nullptr;
+    glfwMakeContextCurrent(window);
+    // Never wait for vsync, we want raw submission cost
+    glfwSwapInterval(0);
+
+    glewExperimental = GL_TRUE;
+    glewInit();
+    return window;
+}
+
+int main(int argc, char** argv) {
+    // Warnings and errors go to std::cout, keep stdout for the JSON only
+    std::cout.rdbuf(std::cerr.rdbuf());
+
+    bool window = argc > 1 && strcmp(argv[1], "--window") == 0;
+    if (!window && !HeadlessContext::IsAvailable()) {
+        fprintf(stderr, "No headless backend in this build, using a window\n");
+        window = true;
+    }
+
+    HeadlessContext headlessContext;
+    if (window) {
+        if (!CreateHiddenWindow()) return -1;
+    } else if (!headlessContext.Create(s_TargetSize, s_TargetSize)) {
+        return -1;
+    }
+    GLEnableDebugOutput();
+
+    {
+        // Kept apart from the app's binaries, the cache benchmark clears it
+        ProgramCache::Get().SetDirectory(".shader_cache/bench");
+
+        // Same target either way, so results are comparable
+        FrameBuffer frameBuffer(s_TargetSize, s_TargetSize);
+        frameBuffer.Bind();
+
+        // Identity camera unless a benchmark needs another one
+        FrameUniforms frame;
+
+        Shader shader("res/shaders/Basic.shader");
+        unsigned int white = 0xffffffff;
+        Texture texture(1, 1, &white);
+        texture.Bind();
+        shader.Bind();
+        shader.SetUniform1i("u_Texture", 0);
+
+        BenchDraws(shader, frame);
+        BenchTriangles(shader);
+        BenchMeshOptimizer(shader);
+        BenchUniforms();
+        BenchObjectUniforms();
+        BenchRenderQueue(frame);
+        BenchTextureUploads();
+        BenchShaderCompile();
+        BenchShaderCache();
+        BenchShaderVariants();
+        BenchBatchRenderer(frame);
+
+        PrintJSON();
+    }
+    // Everything above is gone, delete it while there is still a context
+    DeletionQueue::Get().Flush();
+
+    if (window) glfwTerminate();
+    return 0;
+}
@@ -4,13 +4,14 @@
 layout(location=0) in vec4 position;
 layout(location=1) in vec2 texCoord;
 
-out vec2 v_TexCoord = texCoord;
+out vec2 v_TexCoord;
 
-uniform mat4 u_MVP;
+#include "Blocks.glsl"
 
 void main()
 {
-    gl_Position = u_MVP * position;
+    gl_Position = u_ViewProjection * position;
+    v_TexCoord = texCoord;
 }
 
 #shader fragment
@@ -26,5 +27,9 @@ uniform sampler2D u_Texture;
 void main()
 {
     vec4 texColor = texture(u_Texture, v_TexCoord);
+#ifdef TINT
+    color = texColor * u_Color;
+#else
     color = texColor;
+#endif
 }
\ No newline at end of file
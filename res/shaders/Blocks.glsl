@@ -0,0 +1,16 @@
+// Uniform blocks shared by every shader, bound by name (see UniformBuffer).
+// Members must stay in the order FrameUniforms writes them.
+
+// Set once a frame
+layout(std140) uniform Camera
+{
+    mat4 u_ViewProjection;
+    vec3 u_CameraPosition;
+};
+
+layout(std140) uniform Light
+{
+    vec3 u_LightDirection;
+    vec3 u_LightColor;
+    float u_Ambient;
+};
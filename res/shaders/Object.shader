@@ -0,0 +1,43 @@
+#shader vertex
+#version 330 core
+
+layout(location=0) in vec4 position;
+
+flat out vec4 v_Color;
+
+#include "Blocks.glsl"
+
+// One slot of a UniformRing per draw, PLAIN_UNIFORMS sets the same values
+// with glUniform instead, for comparison
+#ifdef PLAIN_UNIFORMS
+uniform mat4 u_Model;
+uniform vec4 u_ObjectColor;
+#else
+layout(std140) uniform Object
+{
+    mat4 u_Model;
+    vec4 u_ObjectColor;
+};
+#endif
+
+void main()
+{
+    gl_Position = u_ViewProjection * u_Model * position;
+
+    // Lit as a quad facing the camera
+    float diffuse = max(dot(vec3(0.0, 0.0, 1.0), -normalize(u_LightDirection)), 0.0);
+    v_Color = vec4(u_ObjectColor.rgb * u_LightColor * (u_Ambient + diffuse),
+                   u_ObjectColor.a);
+}
+
+#shader fragment
+#version 330 core
+
+layout(location=0) out vec4 color;
+
+flat in vec4 v_Color;
+
+void main()
+{
+    color = v_Color;
+}
@@ -2,12 +2,27 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 #include <string>
 
+#include "DeletionQueue.h"
+#include "FrameBuffer.h"
+#include "FrameClock.h"
+#include "FrameUniforms.h"
+#include "GPUMemory.h"
+#include "HeadlessContext.h"
+#include "ImageWriter.h"
 #include "IndexBuffer.h"
+#include "ProgramCache.h"
 #include "Renderer.h"
+#include "RenderThread.h"
 #include "Shader.h"
+#include "ShaderLibrary.h"
+#include "ShaderReloader.h"
 #include "Texture.h"
 #include "VertexArray.h"
 #include "VertexBuffer.h"
@@ -19,32 +34,104 @@ struct vec4 {
     float v0, v1, v2, v3;
 };
 
-int main(void) {
-    GLFWwindow *window;
-
-    /* Initialize the library */
-    if (!glfwInit()) return -1;
-
-    // Set this for macOS to use latest OpenGL 4.1
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-
-    /* Create a windowed mode window and its OpenGL context */
-    window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
-    if (!window) {
-        glfwTerminate();
-        return -1;
+// Blends two simulated states, a channel that wrapped around to 0 jumps
+// instead of sweeping back through the whole range
+static float Interpolate(float previous, float current, float alpha) {
+    if (current < previous) return current;
+    return previous + (current - previous) * alpha;
+}
+
+static vec4 Interpolate(const vec4 &previous, const vec4 &current,
+                        float alpha) {
+    return {Interpolate(previous.v0, current.v0, alpha),
+            Interpolate(previous.v1, current.v1, alpha),
+            Interpolate(previous.v2, current.v2, alpha),
+            Interpolate(previous.v3, current.v3, alpha)};
+}
+
+static void Advance(vec4 &color, float step) {
+    color.v0 = (color.v0 >= 1.0f) ? 0.0f : color.v0 + step;
+    color.v1 = (color.v1 >= 1.0f) ? 0.0f : color.v1 + step;
+    color.v2 = (color.v2 >= 1.0f) ? 0.0f : color.v2 + step;
+    color.v3 = (color.v3 >= 1.0f) ? 0.0f : color.v3 + step;
+}
+
+int main(int argc, char **argv) {
+    GLFWwindow *window = nullptr;
+    HeadlessContext headlessContext;
+
+    // --no-vsync         don't wait for the monitor, for benchmarking
+    // --fps-limit <fps>  cap the frame rate without vsync
+    // --headless         no window, render offscreen and save a PNG
+    // --frames <n>       frames to render in headless mode
+    // --output <file>    where headless mode saves the last frame
+    // --memory-budget <mb>  warn when GPU allocations go over this
+    // --memory-log <s>   seconds between GPU memory log lines, 0 for none
+    // --no-shader-cache  always compile shaders from source
+    // --no-hot-reload    don't rebuild shaders when res/shaders changes
+    bool vsync = true;
+    double fpsLimit = 0.0;
+    bool headless = false;
+    int frameCount = 60;
+    std::string output = "frame.png";
+    double memoryBudget = 0.0;
+    double memoryLogInterval = 10.0;
+    bool shaderCache = true;
+    bool hotReload = true;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--no-vsync") == 0)
+            vsync = false;
+        else if (strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc)
+            fpsLimit = atof(argv[++i]);
+        else if (strcmp(argv[i], "--headless") == 0)
+            headless = true;
+        else if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+            frameCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+            output = argv[++i];
+        else if (strcmp(argv[i], "--memory-budget") == 0 && i + 1 < argc)
+            memoryBudget = atof(argv[++i]);
+        else if (strcmp(argv[i], "--memory-log") == 0 && i + 1 < argc)
+            memoryLogInterval = atof(argv[++i]);
+        else if (strcmp(argv[i], "--no-shader-cache") == 0)
+            shaderCache = false;
+        else if (strcmp(argv[i], "--no-hot-reload") == 0)
+            hotReload = false;
     }
 
-    /* Make the window's context current */
-    glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);  // Change fps, sync with monitor 60hz
+    if (headless) {
+        if (!headlessContext.Create(640, 480)) return -1;
+    } else {
+        /* Initialize the library */
+        if (!glfwInit()) return -1;
+
+        // Set this for macOS to use latest OpenGL 4.1
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+        // Lets the KHR_debug callback report errors when GLCall doesn't check
+        glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, GL_TRUE);
+
+        /* Create a windowed mode window and its OpenGL context */
+        window = glfwCreateWindow(640, 480, "Hello World", NULL, NULL);
+        if (!window) {
+            glfwTerminate();
+            return -1;
+        }
+
+        /* Make the window's context current */
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(vsync ? 1 : 0);  // 1 syncs with the monitor
+
+        // Initialize GLEW
+        glewExperimental = GL_TRUE;
+        glewInit();
+    }
+    GLEnableDebugOutput();
 
-    // Initialize GLEW
-    glewExperimental = GL_TRUE;
-    glewInit();
+    GPUMemory::Get().SetBudget((std::size_t)(memoryBudget * 1024 * 1024));
+    GPUMemory::Get().SetLogInterval(memoryLogInterval);
 
     // Three vertices with one attribute - position
     float positions[] = {
@@ -74,15 +161,35 @@ int main(void) {
 
     IndexBuffer ib(indices, 6);
 
+    vb.SetDebugName("quad");
+    ib.SetDebugName("quad");
+
     glm::mat4 proj = glm::ortho(-2.0f, 2.0f, -1.5f, 1.5f, -1.0f, 1.0f);
 
-    // Shaders are combined (linked) in one program which will run on GPU
-    Shader shader("res/shaders/Basic.shader");
+    // Shaders are combined (linked) in one program which will run on GPU.
+    // Warm means the program came from the binary cache of an earlier run.
+    ProgramCache::Get().SetEnabled(shaderCache);
+    ShaderLibrary shaders;
+    auto shaderStart = std::chrono::steady_clock::now();
+    Shader &shader = shaders.Get("res/shaders/Basic.shader");
+    std::chrono::duration<double, std::milli> shaderTime =
+        std::chrono::steady_clock::now() - shaderStart;
+    std::cout << "Shader ready in " << shaderTime.count() << " ms ("
+              << (ProgramCache::Get().GetStats().Hits ? "warm" : "cold")
+              << (ProgramCache::IsSupported() ? "" : ", no binary formats")
+              << ")\n";
     shader.Bind();
 
+    // Looked up once, setting it every frame is then just an index
+    UniformHandle colorUniform = shader.GetUniform("u_Color");
+
     vec4 color = {0.2f, 0.3f, 0.8f, 1.0f};
-    shader.SetUniform4f("u_Color", color.v0, color.v1, color.v2, color.v3);
-    shader.SetUniformMat4f("u_MVP", proj);
+    shader.SetUniform4f(colorUniform, color.v0, color.v1, color.v2, color.v3);
+
+    // Camera and light blocks, shared by every shader
+    FrameUniforms frameUniforms;
+    CameraData camera;
+    camera.ViewProjection = proj;
 
     Texture texture("res/textures/masyanya_logo.png");
     texture.Bind();
@@ -102,28 +209,111 @@ int main(void) {
 
     Renderer renderer;
 
-    /* Loop until the user closes the window */
-    while (!glfwWindowShouldClose(window)) {
-        /* Render here */
+    auto drawFrame = [&](const vec4 &drawnColor) {
         renderer.Clear();
+        frameUniforms.SetCamera(camera);
 
         shader.Bind();
-        color.v0 = (color.v0 >= 1.0f) ? 0.0f : color.v0 + 0.05f;
-        color.v1 = (color.v1 >= 1.0f) ? 0.0f : color.v1 + 0.05f;
-        color.v2 = (color.v2 >= 1.0f) ? 0.0f : color.v2 + 0.05f;
-        color.v3 = (color.v3 >= 1.0f) ? 0.0f : color.v3 + 0.05f;
+        shader.SetUniform4f(colorUniform, drawnColor.v0, drawnColor.v1,
+                            drawnColor.v2, drawnColor.v3);
+
+        renderer.Submit(va, ib, shader, &texture);
+        renderer.Flush();
+    };
+
+    // Color channels go from 0 to 1 and wrap, 3 per second is what
+    // 0.05 per frame used to be at 60hz
+    const float colorSpeed = 3.0f;
+
+    if (headless) {
+        // Every frame is exactly one fixed step, the same arguments always
+        // give the same image
+        FrameBuffer frameBuffer(640, 480);
+        frameBuffer.SetDebugName("headless target");
+        frameBuffer.Bind();
+        for (int frame = 0; frame < frameCount; ++frame) {
+            Advance(color, colorSpeed / 60.0f);
+            drawFrame(color);
+            GLCheckpoint("end of frame");
+            DeletionQueue::Get().Collect();
+            GPUMemory::Get().Update();
+        }
+
+        std::vector<unsigned char> pixels = frameBuffer.ReadPixels();
+        if (!WritePNG(output, frameBuffer.GetWidth(), frameBuffer.GetHeight(),
+                      pixels.data())) {
+            std::cout << "Failed to write " << output << '\n';
+            return -1;
+        }
+        std::cout << "Wrote " << frameCount << " frames, last one to "
+                  << output << '\n';
+        GPUMemory::Get().Print(std::cout);
+        GPUMemory::Get().PrintByName(std::cout);
+        return 0;
+    }
+
+    // Saved edits to res/shaders show up without a restart. The hidden
+    // window is only there for its context, which shares programs with ours.
+    std::unique_ptr<ShaderReloader> reloader;
+    if (hotReload) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        GLFWwindow *reloadWindow =
+            glfwCreateWindow(1, 1, "Shader reload", NULL, window);
+        if (reloadWindow) {
+            reloader = std::make_unique<ShaderReloader>(
+                shaders, "res/shaders",
+                [reloadWindow] { glfwMakeContextCurrent(reloadWindow); },
+                [] { glfwMakeContextCurrent(nullptr); });
+            reloader->Start();
+        }
+    }
 
-        shader.SetUniform4f("u_Color", color.v0, color.v1, color.v2, color.v3);
+    // From here on the context belongs to the render thread, this thread
+    // only updates and records
+    RenderThread renderThread(window);
+    renderThread.Start();
 
-        renderer.Draw(va, ib, shader);
+    vec4 previousColor = color;
 
-        /* Swap front and back buffers */
-        glfwSwapBuffers(window);
+    FrameClock clock;
+    clock.SetFrameLimit(fpsLimit);
+
+    /* Loop until the user closes the window */
+    while (!glfwWindowShouldClose(window)) {
+        clock.Tick();
+        while (clock.Step()) {
+            previousColor = color;
+            Advance(color, colorSpeed * clock.GetFixedStep());
+        }
+        vec4 drawnColor =
+            Interpolate(previousColor, color, (float)clock.GetAlpha());
+
+        /* Render here, the render thread swaps buffers after the list */
+        CommandList &commands = renderThread.BeginFrame();
+        commands.Record([&, drawnColor] {
+            if (reloader) reloader->Update();
+            drawFrame(drawnColor);
+        });
+        renderThread.EndFrame();
 
         /* Poll for and process events */
         glfwPollEvents();
+
+        GPUMemory::Get().Update();
     }
 
+    // GL objects are destroyed when main returns, after the context is gone,
+    // so what they queue is freed by the driver along with the context
+    renderThread.Stop();
+    if (reloader) reloader->Stop();
+
+    FrameClock::Stats stats = clock.GetStats();
+    std::cout << "Frame time over the last " << stats.Frames
+              << " frames (ms): avg " << stats.Average * 1000.0 << ", min "
+              << stats.Min * 1000.0 << ", max " << stats.Max * 1000.0
+              << ", 99th percentile " << stats.Percentile99 * 1000.0 << '\n';
+    GPUMemory::Get().Print(std::cout);
+
     glfwTerminate();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,127 @@
+#include "BatchRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Every quad uses the same 0, 1, 2, 2, 3, 0 pattern offset by four vertices,
+// so one index buffer is built up front and shared by all batches
+static std::vector<unsigned int> BuildQuadIndices() {
+    std::vector<unsigned int> indices(BatchRenderer::MaxIndices);
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < BatchRenderer::MaxIndices; i += 6) {
+        indices[i + 0] = offset + 0;
+        indices[i + 1] = offset + 1;
+        indices[i + 2] = offset + 2;
+        indices[i + 3] = offset + 2;
+        indices[i + 4] = offset + 3;
+        indices[i + 5] = offset + 0;
+        offset += 4;
+    }
+    return indices;
+}
+
+static const unsigned int s_WhitePixel = 0xffffffff;
+
+BatchRenderer::BatchRenderer(Shader& shader)
+    : m_Shader(shader),
+      // Two full batches per frame before the stream moves on early
+      m_VertexStream(2 * MaxVertices * sizeof(QuadVertex)),
+      m_WhiteTexture(1, 1, &s_WhitePixel),
+      m_TextureSlotCount(1) {
+    m_VertexArray.AddBuffer<QuadVertexLayout>(m_VertexStream);
+
+    // MaxVertices fits in 16 bits, IndexBuffer stores these as shorts
+    std::vector<unsigned int> indices = BuildQuadIndices();
+    m_IndexBuffer = std::make_unique<IndexBuffer>(indices.data(), MaxIndices);
+    m_VertexArray.SetIndexBuffer(*m_IndexBuffer);
+
+    m_VertexStream.SetDebugName("batch quads");
+    m_IndexBuffer->SetDebugName("batch quads");
+
+    // Start small, the array grows with the scene
+    m_Vertices.reserve(1024);
+
+    // Fragment shaders may have fewer texture units than the shader declares
+    int maxUnits;
+    GLCall(glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits));
+    m_TextureSlotLimit = std::min<unsigned int>(MaxTextureSlots, maxUnits);
+
+    m_TextureSlots.fill(nullptr);
+    m_TextureSlots[0] = &m_WhiteTexture;
+
+    // Sampler i reads from texture unit i
+    int samplers[MaxTextureSlots];
+    for (unsigned int i = 0; i < MaxTextureSlots; ++i) samplers[i] = i;
+    m_Shader.Bind();
+    m_Shader.SetUniform1iv("u_Textures", MaxTextureSlots, samplers);
+
+    m_VertexArray.Unbind();
+    m_IndexBuffer->Unbind();
+}
+
+void BatchRenderer::Begin() {
+    m_Vertices.clear();
+    m_TextureSlotCount = 1;
+}
+
+void BatchRenderer::End() {
+    Flush();
+    m_VertexStream.EndFrame();
+}
+
+void BatchRenderer::Flush() {
+    if (m_Vertices.empty()) return;
+
+    // Aligned to the vertex size, so the offset is a whole base vertex
+    StreamingBuffer::Allocation allocation = m_VertexStream.Allocate(
+        m_Vertices.size() * sizeof(QuadVertex), sizeof(QuadVertex));
+    memcpy(allocation.Data, m_Vertices.data(), allocation.Size);
+    m_VertexStream.Commit(allocation);
+
+    for (unsigned int i = 0; i < m_TextureSlotCount; ++i)
+        m_TextureSlots[i]->Bind(i);
+
+    unsigned int quadCount = m_Vertices.size() / 4;
+    m_Renderer.Draw(m_VertexArray, *m_IndexBuffer, m_Shader, quadCount * 6, 0,
+                    allocation.Offset / sizeof(QuadVertex));
+
+    m_Stats.DrawCalls++;
+    m_Stats.QuadCount += quadCount;
+
+    m_Vertices.clear();
+    m_TextureSlotCount = 1;
+}
+
+float BatchRenderer::GetTextureIndex(const Texture& texture) {
+    for (unsigned int i = 1; i < m_TextureSlotCount; ++i)
+        if (m_TextureSlots[i] == &texture) return (float)i;
+
+    // Out of texture units, draw what we have and start a new set
+    if (m_TextureSlotCount == m_TextureSlotLimit) Flush();
+
+    m_TextureSlots[m_TextureSlotCount] = &texture;
+    return (float)m_TextureSlotCount++;
+}
+
+void BatchRenderer::PushQuad(const glm::vec2& position, const glm::vec2& size,
+                             const glm::vec4& color, float texIndex) {
+    const glm::vec2 corners[4] = {{0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f},
+                                  {0.0f, 1.0f}};
+    for (const glm::vec2& corner : corners)
+        m_Vertices.push_back(
+            {position + corner * size, corner, color, texIndex});
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size,
+                             const glm::vec4& color) {
+    if (m_Vertices.size() >= MaxVertices) Flush();
+    PushQuad(position, size, color, 0.0f);
+}
+
+void BatchRenderer::DrawQuad(const glm::vec2& position, const glm::vec2& size,
+                             const Texture& texture, const glm::vec4& tint) {
+    if (m_Vertices.size() >= MaxVertices) Flush();
+    // Looked up after the capacity check, a flush resets the texture slots
+    float texIndex = GetTextureIndex(texture);
+    PushQuad(position, size, tint, texIndex);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "IndexBuffer.h"
+#include "Renderer.h"
+#include "Shader.h"
+#include "StreamingBuffer.h"
+#include "Texture.h"
+#include "VertexArray.h"
+#include "VertexBufferLayout.h"
+#include "glm/glm.hpp"
+
+// One corner of a quad as it is laid out in the streaming vertex buffer
+struct QuadVertex {
+    glm::vec2 Position;
+    glm::vec2 TexCoord;
+    glm::vec4 Color;
+    float TexIndex;
+};
+
+using QuadVertexLayout = Layout<Vec2, Vec2, Vec4, Float>;
+static_assert(QuadVertexLayout::Stride == sizeof(QuadVertex),
+              "QuadVertexLayout does not match QuadVertex");
+
+// Gathers quads into one CPU-side vertex array and draws them with a single
+// glDrawElements per set of textures instead of one draw per quad
+class BatchRenderer {
+   public:
+    static const unsigned int MaxQuads = 10000;
+    static const unsigned int MaxVertices = MaxQuads * 4;
+    static const unsigned int MaxIndices = MaxQuads * 6;
+    // Must match the size of u_Textures in res/shaders/Batch.shader
+    static const unsigned int MaxTextureSlots = 16;
+
+    struct Stats {
+        unsigned int DrawCalls = 0;
+        unsigned int QuadCount = 0;
+    };
+
+   private:
+    Shader& m_Shader;
+    Renderer m_Renderer;
+
+    VertexArray m_VertexArray;
+    // Each flush writes to fresh memory, never to vertices a previous draw
+    // may still be reading
+    StreamingBuffer m_VertexStream;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+    // Grows on demand up to MaxVertices, then the batch is flushed
+    std::vector<QuadVertex> m_Vertices;
+
+    // Slot 0 is always the 1x1 white texture used for plain colored quads
+    Texture m_WhiteTexture;
+    std::array<const Texture*, MaxTextureSlots> m_TextureSlots;
+    unsigned int m_TextureSlotCount;
+    unsigned int m_TextureSlotLimit;
+
+    Stats m_Stats;
+
+   public:
+    BatchRenderer(Shader& shader);
+
+    void Begin();
+    // Call once per frame, ends the frame of the vertex stream as well
+    void End();
+
+    void DrawQuad(const glm::vec2& position, const glm::vec2& size,
+                  const glm::vec4& color);
+    void DrawQuad(const glm::vec2& position, const glm::vec2& size,
+                  const Texture& texture,
+                  const glm::vec4& tint = glm::vec4(1.0f));
+
+    inline const Stats& GetStats() const { return m_Stats; }
+    inline void ResetStats() { m_Stats = Stats(); }
+
+   private:
+    void Flush();
+    float GetTextureIndex(const Texture& texture);
+    void PushQuad(const glm::vec2& position, const glm::vec2& size,
+                  const glm::vec4& color, float texIndex);
+};
@@ -0,0 +1,59 @@
+#include "BufferArena.h"
+
+#include "VertexBufferLayout.h"
+
+BufferArena::BufferArena(const VertexBufferLayout& layout,
+                         unsigned int vertexCapacity,
+                         unsigned int indexCapacity, IndexType indexType)
+    : m_Stride(layout.GetStride()),
+      m_VertexBuffer(vertexCapacity * layout.GetStride(), BufferUsage::Static),
+      m_IndexBuffer(
+          std::make_unique<IndexBuffer>(indexCapacity, indexType,
+                                        BufferUsage::Static)),
+      m_Vertices(vertexCapacity),
+      m_Indices(indexCapacity) {
+    m_VertexArray.AddBuffer(m_VertexBuffer, layout);
+    m_VertexArray.SetIndexBuffer(*m_IndexBuffer);
+
+    m_VertexBuffer.SetDebugName("arena");
+    m_IndexBuffer->SetDebugName("arena");
+}
+
+MeshRange BufferArena::Allocate(const void* vertices, unsigned int vertexCount,
+                                const unsigned int* indices,
+                                unsigned int indexCount) {
+    if (!vertexCount || !indexCount) return {0, 0, 0, 0};
+
+    unsigned int baseVertex = m_Vertices.Allocate(vertexCount);
+    if (baseVertex == RangeAllocator::Invalid) {
+        unsigned int capacity = GrowCapacity(m_Vertices.GetCapacity(),
+                                             m_Vertices.GetCapacity() +
+                                                 vertexCount);
+        m_VertexBuffer.Reserve(capacity * m_Stride);
+        m_Vertices.Grow(capacity);
+        baseVertex = m_Vertices.Allocate(vertexCount);
+        ASSERT(baseVertex != RangeAllocator::Invalid);
+    }
+
+    unsigned int firstIndex = m_Indices.Allocate(indexCount);
+    if (firstIndex == RangeAllocator::Invalid) {
+        unsigned int capacity = GrowCapacity(m_Indices.GetCapacity(),
+                                             m_Indices.GetCapacity() +
+                                                 indexCount);
+        m_IndexBuffer->Reserve(capacity);
+        m_Indices.Grow(capacity);
+        firstIndex = m_Indices.Allocate(indexCount);
+        ASSERT(firstIndex != RangeAllocator::Invalid);
+    }
+
+    m_VertexBuffer.Update(vertices, vertexCount * m_Stride,
+                          baseVertex * m_Stride);
+    m_IndexBuffer->Update(indices, indexCount, firstIndex);
+
+    return {firstIndex, indexCount, (int)baseVertex, vertexCount};
+}
+
+void BufferArena::Free(const MeshRange& mesh) {
+    m_Vertices.Free(mesh.BaseVertex, mesh.VertexCount);
+    m_Indices.Free(mesh.FirstIndex, mesh.IndexCount);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <memory>
+
+#include "IndexBuffer.h"
+#include "RangeAllocator.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+
+class VertexBufferLayout;
+
+// Where a mesh lives inside a BufferArena. Indices are relative to the
+// mesh's first vertex, draws add BaseVertex to them:
+//   renderer.Draw(arena.GetVertexArray(), arena.GetIndexBuffer(), shader,
+//                 mesh.IndexCount, mesh.FirstIndex, mesh.BaseVertex);
+// or commands.Add(mesh.IndexCount, mesh.FirstIndex, mesh.BaseVertex) to
+// draw many meshes with one Renderer::MultiDrawIndirect.
+struct MeshRange {
+    unsigned int FirstIndex;
+    unsigned int IndexCount;
+    int BaseVertex;
+    unsigned int VertexCount;
+};
+
+// Many meshes of the same vertex format packed into one vertex buffer and
+// one index buffer, drawn through a single vertex array. Switching meshes
+// is then only a change of draw offsets, no buffer or vertex array binds.
+// Both buffers grow when full, their GL names stay the same so the vertex
+// array keeps working.
+class BufferArena {
+   private:
+    unsigned int m_Stride;
+
+    VertexArray m_VertexArray;
+    VertexBuffer m_VertexBuffer;
+    std::unique_ptr<IndexBuffer> m_IndexBuffer;
+
+    // In vertices and indices, not bytes
+    RangeAllocator m_Vertices;
+    RangeAllocator m_Indices;
+
+   public:
+    // With IndexType::UInt16 indices take half the space, but no single
+    // mesh may have more than 65536 vertices
+    BufferArena(const VertexBufferLayout& layout, unsigned int vertexCapacity,
+                unsigned int indexCapacity,
+                IndexType indexType = IndexType::UInt32);
+
+    // Copies the mesh into the arena. A mesh without vertices or indices
+    // takes no space and gets an empty range, which draws nothing
+    MeshRange Allocate(const void* vertices, unsigned int vertexCount,
+                       const unsigned int* indices, unsigned int indexCount);
+    // The space can be reused by later allocations, draws of the range must
+    // not be issued afterwards
+    void Free(const MeshRange& mesh);
+
+    inline const VertexArray& GetVertexArray() const { return m_VertexArray; }
+    inline const IndexBuffer& GetIndexBuffer() const { return *m_IndexBuffer; }
+
+    inline RangeAllocator::Stats GetVertexStats() const {
+        return m_Vertices.GetStats();
+    }
+    inline RangeAllocator::Stats GetIndexStats() const {
+        return m_Indices.GetStats();
+    }
+};
@@ -0,0 +1,70 @@
+#include "BufferUsage.h"
+
+#include "Renderer.h"
+
+unsigned int BufferCreate() {
+    unsigned int id;
+    if (GLHasDirectStateAccess()) {
+        GLCall(glCreateBuffers(1, &id));
+    } else {
+        GLCall(glGenBuffers(1, &id));
+    }
+    return id;
+}
+
+void BufferReallocate(unsigned int id, unsigned int size, BufferUsage usage,
+                      unsigned int keepSize) {
+    if (!keepSize) {
+        BufferAllocate(id, size, usage);
+        return;
+    }
+
+    // glBufferData drops the old contents, park them in a scratch buffer
+    unsigned int scratch = BufferCreate();
+    if (GLHasDirectStateAccess()) {
+        GLCall(glNamedBufferData(scratch, keepSize, nullptr, GL_STREAM_COPY));
+        GLCall(glCopyNamedBufferSubData(id, scratch, 0, 0, keepSize));
+        GLCall(glNamedBufferData(id, size, nullptr,
+                                 static_cast<GLenum>(usage)));
+        GLCall(glCopyNamedBufferSubData(scratch, id, 0, 0, keepSize));
+        GLCall(glDeleteBuffers(1, &scratch));
+        return;
+    }
+
+    GLCall(glBindBuffer(GL_COPY_READ_BUFFER, id));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, scratch));
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, keepSize, nullptr,
+                        GL_STREAM_COPY));
+    GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                               keepSize));
+
+    GLCall(glBindBuffer(GL_COPY_READ_BUFFER, scratch));
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr,
+                        static_cast<GLenum>(usage)));
+    GLCall(glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0,
+                               keepSize));
+
+    GLCall(glDeleteBuffers(1, &scratch));
+}
+
+void BufferAllocate(unsigned int id, unsigned int size, BufferUsage usage,
+                    const void* data) {
+    if (GLHasDirectStateAccess()) {
+        GLCall(glNamedBufferData(id, size, data, static_cast<GLenum>(usage)));
+        return;
+    }
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+    GLCall(glBufferData(GL_COPY_WRITE_BUFFER, size, data,
+                        static_cast<GLenum>(usage)));
+}
+
+void BufferWrite(unsigned int id, unsigned int offset, unsigned int size,
+                 const void* data) {
+    if (GLHasDirectStateAccess()) {
+        GLCall(glNamedBufferSubData(id, offset, size, data));
+        return;
+    }
+    GLCall(glBindBuffer(GL_COPY_WRITE_BUFFER, id));
+    GLCall(glBufferSubData(GL_COPY_WRITE_BUFFER, offset, size, data));
+}
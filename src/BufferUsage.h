@@ -0,0 +1,39 @@
+#pragma once
+
+// How often a buffer's contents change, passed to glBufferData as a hint.
+// The values are the GL enums, so they cast straight to them.
+enum class BufferUsage : unsigned int {
+    // Written once, drawn many times (GL_STATIC_DRAW)
+    Static = 0x88E4,
+    // Rewritten now and then, drawn many times (GL_DYNAMIC_DRAW)
+    Dynamic = 0x88E8,
+    // Rewritten before nearly every draw (GL_STREAM_DRAW)
+    Stream = 0x88E0,
+};
+
+// Capacity to grow to when required bytes don't fit, doubling so a buffer
+// that keeps growing is reallocated only a logarithmic number of times
+inline unsigned int GrowCapacity(unsigned int capacity, unsigned int required) {
+    unsigned int grown = capacity * 2;
+    return grown > required ? grown : required;
+}
+
+// The helpers below work by name with direct state access and through
+// GL_COPY_WRITE_BUFFER otherwise, so they never touch the GL_ARRAY_BUFFER
+// binding or the element buffer of the bound vertex array
+
+// A new buffer name, with DSA the buffer object exists right away and can
+// be used without ever binding it
+unsigned int BufferCreate();
+
+// New storage of size bytes for the buffer, the first keepSize bytes of the
+// old storage are copied over
+void BufferReallocate(unsigned int id, unsigned int size, BufferUsage usage,
+                      unsigned int keepSize = 0);
+// New storage of size bytes filled from data. With data nullptr this is how
+// a buffer is orphaned: the old storage is detached, so the driver can hand
+// us fresh memory instead of waiting for draws that still read it.
+void BufferAllocate(unsigned int id, unsigned int size, BufferUsage usage,
+                    const void* data = nullptr);
+void BufferWrite(unsigned int id, unsigned int offset, unsigned int size,
+                 const void* data);
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+// GL work recorded on one thread to be executed on the thread owning the
+// context. Commands capture what they need by value, the recording thread
+// is free to change its copies as soon as the command is recorded.
+class CommandList {
+   private:
+    std::vector<std::function<void()>> m_Commands;
+
+   public:
+    inline void Record(std::function<void()> command) {
+        m_Commands.push_back(std::move(command));
+    }
+
+    inline void Execute() const {
+        for (const auto& command : m_Commands) command();
+    }
+
+    // Keeps the capacity, lists are reused frame after frame
+    inline void Clear() { m_Commands.clear(); }
+
+    inline unsigned int GetCount() const { return m_Commands.size(); }
+};
@@ -0,0 +1,108 @@
+#include "DeletionQueue.h"
+
+#include "GLState.h"
+
+DeletionQueue& DeletionQueue::Get() {
+    static DeletionQueue s_Queue;
+    return s_Queue;
+}
+
+void DeletionQueue::Push(GLObjectType type, unsigned int name) {
+    if (!name) return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Pending[static_cast<unsigned int>(type)].push_back(name);
+    m_Stats.Queued++;
+}
+
+DeletionQueue::Batch DeletionQueue::TakePending() {
+    Batch batch;
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (unsigned int type = 0; type < TypeCount; ++type)
+        batch.Names[type].swap(m_Pending[type]);
+    return batch;
+}
+
+void DeletionQueue::Collect() {
+    Batch batch = TakePending();
+    for (const auto& names : batch.Names) {
+        if (names.empty()) continue;
+        // Signals once every command issued so far, which includes any
+        // draw that used these objects, has finished
+        GLCall(batch.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        m_Batches.push_back(std::move(batch));
+        break;
+    }
+
+    // Fences signal in order, stop at the first one still pending
+    while (!m_Batches.empty()) {
+        GLenum status;
+        GLCall(status = glClientWaitSync(m_Batches.front().Fence, 0, 0));
+        if (status == GL_TIMEOUT_EXPIRED) break;
+
+        Delete(m_Batches.front());
+        m_Batches.pop_front();
+    }
+}
+
+void DeletionQueue::Flush() {
+    // GL itself keeps objects alive while queued commands still use them
+    Batch batch = TakePending();
+    Delete(batch);
+    for (Batch& pending : m_Batches) Delete(pending);
+    m_Batches.clear();
+}
+
+DeletionQueue::Stats DeletionQueue::GetStats() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Stats;
+}
+
+void DeletionQueue::Delete(Batch& batch) {
+    if (batch.Fence) {
+        GLCall(glDeleteSync(batch.Fence));
+        batch.Fence = nullptr;
+    }
+
+    GLState& state = GLState::Get();
+    unsigned int deleted = 0, calls = 0;
+    for (unsigned int type = 0; type < TypeCount; ++type) {
+        std::vector<unsigned int>& names = batch.Names[type];
+        if (names.empty()) continue;
+
+        // The names are free for reuse after this, forget their bindings
+        switch (static_cast<GLObjectType>(type)) {
+            case GLObjectType::Buffer:
+                for (unsigned int name : names) state.OnDeleteBuffer(name);
+                GLCall(glDeleteBuffers(names.size(), names.data()));
+                break;
+            case GLObjectType::VertexArray:
+                for (unsigned int name : names)
+                    state.OnDeleteVertexArray(name);
+                GLCall(glDeleteVertexArrays(names.size(), names.data()));
+                break;
+            case GLObjectType::Texture:
+                for (unsigned int name : names) state.OnDeleteTexture(name);
+                GLCall(glDeleteTextures(names.size(), names.data()));
+                break;
+            case GLObjectType::Program:
+                // No batched call for programs
+                for (unsigned int name : names) {
+                    state.OnDeleteProgram(name);
+                    GLCall(glDeleteProgram(name));
+                }
+                break;
+            case GLObjectType::Count:
+                break;
+        }
+        deleted += names.size();
+        calls += type == static_cast<unsigned int>(GLObjectType::Program)
+                     ? names.size()
+                     : 1;
+        names.clear();
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Stats.Deleted += deleted;
+    m_Stats.DeleteCalls += calls;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <vector>
+
+#include "Renderer.h"
+
+enum class GLObjectType { Buffer, VertexArray, Texture, Program, Count };
+
+// GL objects are not deleted by their destructors but queued here, which
+// makes destroying a resource safe on any thread, including ones without a
+// current context. Collect, called once a frame on the thread that has the
+// context, fences everything queued since the last call and deletes batches
+// whose fence has signaled, so the GPU is done with them and deleting them
+// cannot make the driver wait. Names of one type go to GL in a single
+// glDelete* call.
+class DeletionQueue {
+   public:
+    struct Stats {
+        unsigned int Queued = 0;
+        unsigned int Deleted = 0;
+        // glDelete* calls made, one per type and batch except for programs
+        unsigned int DeleteCalls = 0;
+    };
+
+   private:
+    static const unsigned int TypeCount =
+        static_cast<unsigned int>(GLObjectType::Count);
+
+    struct Batch {
+        GLsync Fence = nullptr;
+        std::vector<unsigned int> Names[TypeCount];
+    };
+
+    // Pushed from any thread
+    std::mutex m_Mutex;
+    std::vector<unsigned int> m_Pending[TypeCount];
+    Stats m_Stats;
+
+    // Only touched by the GL thread
+    std::deque<Batch> m_Batches;
+
+   public:
+    static DeletionQueue& Get();
+
+    // Name 0 is ignored, that is what moved-from resources hold
+    void Push(GLObjectType type, unsigned int name);
+
+    // Call on the GL thread once per frame, after the frame's draws
+    void Collect();
+    // Deletes everything right away, call before destroying the context
+    void Flush();
+
+    Stats GetStats();
+
+   private:
+    // Moves the pending names into a new batch
+    Batch TakePending();
+    void Delete(Batch& batch);
+};
@@ -0,0 +1,122 @@
+#include "FileWatcher.h"
+
+#include <algorithm>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+std::string FileWatcher::Normalize(const std::string& path) {
+    return fs::path(path).lexically_normal().generic_string();
+}
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(const std::string& directory)
+    : m_Directory(Normalize(directory)),
+      m_Descriptor(inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) {
+    if (m_Descriptor < 0) {
+        std::cout << "inotify unavailable, not watching " << directory << '\n';
+        return;
+    }
+    Watch(m_Directory);
+}
+
+FileWatcher::~FileWatcher() {
+    if (m_Descriptor >= 0) close(m_Descriptor);
+}
+
+void FileWatcher::Watch(const std::string& directory) {
+    // Editors either write in place or write a copy and rename it over the
+    // original, catch both but not every partial write
+    const uint32_t mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE;
+    int watch = inotify_add_watch(m_Descriptor, directory.c_str(), mask);
+    if (watch < 0) return;
+    m_Watches[watch] = directory;
+
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error))
+        if (entry.is_directory())
+            Watch(Normalize(entry.path().generic_string()));
+}
+
+std::vector<std::string> FileWatcher::Poll() {
+    std::vector<std::string> changed;
+    if (m_Descriptor < 0) return changed;
+
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(m_Descriptor, buffer, sizeof(buffer));
+        // EAGAIN, nothing more to read
+        if (length <= 0) break;
+
+        for (char* p = buffer; p < buffer + length;) {
+            const inotify_event* event = (const inotify_event*)p;
+            p += sizeof(inotify_event) + event->len;
+
+            auto watch = m_Watches.find(event->wd);
+            if (watch == m_Watches.end() || !event->len) continue;
+            std::string path = Normalize(watch->second + "/" + event->name);
+
+            if (event->mask & IN_ISDIR) {
+                // New subdirectories are watched too
+                if (event->mask & (IN_CREATE | IN_MOVED_TO)) Watch(path);
+                continue;
+            }
+            // A created file shows up again once it has been written
+            if (event->mask & IN_CREATE) continue;
+            changed.push_back(path);
+        }
+    }
+
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    return changed;
+}
+
+#else
+
+FileWatcher::FileWatcher(const std::string& directory)
+    : m_Directory(Normalize(directory)), m_LastScan(Clock::now()) {
+    Watch(m_Directory);
+}
+
+FileWatcher::~FileWatcher() {}
+
+void FileWatcher::Watch(const std::string& directory) {
+    std::error_code error;
+    for (const auto& entry :
+         fs::recursive_directory_iterator(directory, error)) {
+        if (entry.is_regular_file())
+            m_WriteTimes[Normalize(entry.path().generic_string())] =
+                entry.last_write_time(error);
+    }
+}
+
+std::vector<std::string> FileWatcher::Poll() {
+    std::vector<std::string> changed;
+    // Scanning is cheap but not free, every frame would be wasteful
+    Clock::time_point now = Clock::now();
+    if (now - m_LastScan < std::chrono::milliseconds(250)) return changed;
+    m_LastScan = now;
+
+    std::error_code error;
+    for (const auto& entry :
+         fs::recursive_directory_iterator(m_Directory, error)) {
+        if (!entry.is_regular_file()) continue;
+        std::string path = Normalize(entry.path().generic_string());
+        fs::file_time_type time = entry.last_write_time(error);
+        auto known = m_WriteTimes.find(path);
+        if (known == m_WriteTimes.end() || known->second != time) {
+            m_WriteTimes[path] = time;
+            changed.push_back(path);
+        }
+    }
+    return changed;
+}
+
+#endif
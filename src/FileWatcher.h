@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+// Reports files under a directory (and its subdirectories) that were
+// written or replaced. Uses inotify on Linux, elsewhere it compares
+// modification times a few times a second. Poll never blocks.
+class FileWatcher {
+   private:
+    std::string m_Directory;
+
+#ifdef __linux__
+    int m_Descriptor;
+    // Watch descriptor to the directory it watches
+    std::map<int, std::string> m_Watches;
+#else
+    using Clock = std::chrono::steady_clock;
+    std::map<std::string, std::filesystem::file_time_type> m_WriteTimes;
+    Clock::time_point m_LastScan;
+#endif
+
+   public:
+    FileWatcher(const std::string& directory);
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Files changed since the last call, each once, as normalized paths
+    // starting with the watched directory
+    std::vector<std::string> Poll();
+
+    inline const std::string& GetDirectory() const { return m_Directory; }
+
+    // The form Poll reports paths in, use it before comparing
+    static std::string Normalize(const std::string& path);
+
+   private:
+    // Starts watching directory and everything below it
+    void Watch(const std::string& directory);
+};
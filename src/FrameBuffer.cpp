@@ -0,0 +1,71 @@
+#include "FrameBuffer.h"
+
+#include "GPUMemory.h"
+#include "Renderer.h"
+
+FrameBuffer::FrameBuffer(int width, int height)
+    : m_RendererID(0),
+      m_ColorAttachment(0),
+      m_DepthAttachment(0),
+      m_Width(width),
+      m_Height(height) {
+    GLCall(glGenFramebuffers(1, &m_RendererID));
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+
+    // Renderbuffers, we only ever read the result back to the CPU
+    GLCall(glGenRenderbuffers(1, &m_ColorAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_ColorAttachment));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                                     GL_RENDERBUFFER, m_ColorAttachment));
+
+    GLCall(glGenRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment));
+    GLCall(glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width,
+                                 height));
+    GLCall(glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+                                     GL_RENDERBUFFER, m_DepthAttachment));
+
+    GLCall(glBindRenderbuffer(GL_RENDERBUFFER, 0));
+    ASSERT(IsComplete());
+    Unbind();
+
+    // Drivers store 24-bit depth in 4 bytes
+    GPUMemory::Get().Track(MemoryCategory::RenderTarget, m_RendererID,
+                           GPUMemory::GetTextureSize(width, height, 4 + 4, 1));
+}
+
+FrameBuffer::~FrameBuffer() {
+    GPUMemory::Get().Untrack(MemoryCategory::RenderTarget, m_RendererID);
+    GLCall(glDeleteRenderbuffers(1, &m_ColorAttachment));
+    GLCall(glDeleteRenderbuffers(1, &m_DepthAttachment));
+    GLCall(glDeleteFramebuffers(1, &m_RendererID));
+}
+
+void FrameBuffer::Bind() const {
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID));
+    GLCall(glViewport(0, 0, m_Width, m_Height));
+}
+
+void FrameBuffer::Unbind() const {
+    GLCall(glBindFramebuffer(GL_FRAMEBUFFER, 0));
+}
+
+void FrameBuffer::SetDebugName(const std::string& name) {
+    GPUMemory::Get().SetName(MemoryCategory::RenderTarget, m_RendererID, name);
+}
+
+bool FrameBuffer::IsComplete() const {
+    GLCall(GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER));
+    return status == GL_FRAMEBUFFER_COMPLETE;
+}
+
+std::vector<unsigned char> FrameBuffer::ReadPixels() const {
+    std::vector<unsigned char> pixels(m_Width * m_Height * 4);
+    GLCall(glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID));
+    // Rows are tightly packed, RGBA rows are always 4-byte aligned anyway
+    GLCall(glPixelStorei(GL_PACK_ALIGNMENT, 1));
+    GLCall(glReadPixels(0, 0, m_Width, m_Height, GL_RGBA, GL_UNSIGNED_BYTE,
+                        pixels.data()));
+    return pixels;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Offscreen render target with an RGBA8 color and a depth attachment.
+// Needed wherever there is no window to draw to.
+class FrameBuffer {
+   private:
+    unsigned int m_RendererID;
+    unsigned int m_ColorAttachment;
+    unsigned int m_DepthAttachment;
+    int m_Width, m_Height;
+
+   public:
+    FrameBuffer(int width, int height);
+    ~FrameBuffer();
+
+    // A copy would delete the GL objects twice
+    FrameBuffer(const FrameBuffer &) = delete;
+    FrameBuffer &operator=(const FrameBuffer &) = delete;
+
+    // Also sets the viewport to cover the whole target
+    void Bind() const;
+    void Unbind() const;
+
+    // Name the attachments' memory is reported under, see GPUMemory
+    void SetDebugName(const std::string& name);
+
+    bool IsComplete() const;
+
+    // RGBA8 pixels, bottom row first like GL returns them
+    std::vector<unsigned char> ReadPixels() const;
+
+    inline int GetWidth() const { return m_Width; }
+    inline int GetHeight() const { return m_Height; }
+};
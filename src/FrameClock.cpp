@@ -0,0 +1,88 @@
+#include "FrameClock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+// Sleeping is only accurate to a millisecond or two, the rest of the wait
+// is spent spinning so frames come out evenly spaced
+static const double s_SpinThreshold = 0.002;
+
+FrameClock::FrameClock(double fixedStep)
+    : m_FixedStep(fixedStep),
+      m_Accumulator(0.0),
+      m_MaxStepsPerFrame(8),
+      m_StepsThisFrame(0),
+      m_TargetFrameTime(0.0),
+      m_LastTick(Clock::now()),
+      m_FrameTime(0.0),
+      m_NextSample(0) {
+    m_Samples.reserve(SampleCount);
+}
+
+void FrameClock::SetFrameLimit(double fps) {
+    m_TargetFrameTime = fps > 0.0 ? 1.0 / fps : 0.0;
+}
+
+void FrameClock::WaitForTarget() const {
+    auto deadline =
+        m_LastTick + std::chrono::duration_cast<Clock::duration>(
+                         std::chrono::duration<double>(m_TargetFrameTime));
+
+    std::chrono::duration<double> remaining = deadline - Clock::now();
+    if (remaining.count() > s_SpinThreshold)
+        std::this_thread::sleep_for(
+            remaining - std::chrono::duration<double>(s_SpinThreshold));
+
+    while (Clock::now() < deadline)
+        ;
+}
+
+void FrameClock::Tick() {
+    if (m_TargetFrameTime > 0.0) WaitForTarget();
+
+    Clock::time_point now = Clock::now();
+    m_FrameTime = std::chrono::duration<double>(now - m_LastTick).count();
+    m_LastTick = now;
+
+    if (m_Samples.size() < SampleCount)
+        m_Samples.push_back(m_FrameTime);
+    else
+        m_Samples[m_NextSample] = m_FrameTime;
+    m_NextSample = (m_NextSample + 1) % SampleCount;
+
+    m_Accumulator += m_FrameTime;
+    m_StepsThisFrame = 0;
+}
+
+bool FrameClock::Step() {
+    if (m_Accumulator < m_FixedStep) return false;
+
+    if (m_StepsThisFrame == m_MaxStepsPerFrame) {
+        // Drop the backlog, the simulation slows down instead of spiraling
+        m_Accumulator = std::fmod(m_Accumulator, m_FixedStep);
+        return false;
+    }
+
+    m_Accumulator -= m_FixedStep;
+    m_StepsThisFrame++;
+    return true;
+}
+
+FrameClock::Stats FrameClock::GetStats() const {
+    Stats stats;
+    if (m_Samples.empty()) return stats;
+
+    std::vector<double> sorted(m_Samples);
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (double sample : sorted) sum += sample;
+
+    stats.Frames = sorted.size();
+    stats.Average = sum / sorted.size();
+    stats.Min = sorted.front();
+    stats.Max = sorted.back();
+    stats.Percentile99 = sorted[(sorted.size() - 1) * 99 / 100];
+    return stats;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+
+// Measures frames and turns them into fixed simulation steps, so the
+// animation runs at the same speed no matter the refresh rate.
+//
+//   clock.Tick();
+//   while (clock.Step()) Update(clock.GetFixedStep());
+//   Render(Interpolate(previous, current, clock.GetAlpha()));
+class FrameClock {
+   public:
+    // In seconds, over the last SampleCount frames
+    struct Stats {
+        unsigned int Frames = 0;
+        double Average = 0.0;
+        double Min = 0.0;
+        double Max = 0.0;
+        double Percentile99 = 0.0;
+    };
+
+    static const unsigned int SampleCount = 240;
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    double m_FixedStep;
+    double m_Accumulator;
+    // After a long stall (breakpoint, window drag) don't try to catch up
+    // on every missed step
+    unsigned int m_MaxStepsPerFrame;
+    unsigned int m_StepsThisFrame;
+
+    // 0 means uncapped
+    double m_TargetFrameTime;
+
+    Clock::time_point m_LastTick;
+    double m_FrameTime;
+
+    std::vector<double> m_Samples;
+    unsigned int m_NextSample;
+
+   public:
+    FrameClock(double fixedStep = 1.0 / 60.0);
+
+    // Call once per frame. Waits for the frame limiter if one is set,
+    // then measures the frame and adds it to the simulation time.
+    void Tick();
+    // True while there is a whole fixed step left to simulate
+    bool Step();
+
+    // How far we are between the last two simulated states, in [0, 1)
+    inline double GetAlpha() const { return m_Accumulator / m_FixedStep; }
+    inline double GetFixedStep() const { return m_FixedStep; }
+    // Time the last frame took, including the limiter wait
+    inline double GetFrameTime() const { return m_FrameTime; }
+
+    // fps of 0 removes the limit
+    void SetFrameLimit(double fps);
+
+    Stats GetStats() const;
+
+   private:
+    void WaitForTarget() const;
+};
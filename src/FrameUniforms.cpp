@@ -0,0 +1,52 @@
+#include "FrameUniforms.h"
+
+#include "Std140.h"
+
+// Large enough for either block
+static const unsigned int s_MaxBlockSize = 128;
+
+static void Pack(Std140Writer& writer, const CameraData& camera) {
+    writer.Write(camera.ViewProjection);
+    writer.Write(camera.Position);
+}
+
+static void Pack(Std140Writer& writer, const LightData& light) {
+    writer.Write(light.Direction);
+    writer.Write(light.Color);
+    writer.Write(light.Ambient);
+}
+
+unsigned int FrameUniforms::GetCameraSize() {
+    Std140Writer size(nullptr, 0);
+    Pack(size, CameraData());
+    return size.GetSize();
+}
+
+unsigned int FrameUniforms::GetLightSize() {
+    Std140Writer size(nullptr, 0);
+    Pack(size, LightData());
+    return size.GetSize();
+}
+
+FrameUniforms::FrameUniforms()
+    : m_Camera("Camera", GetCameraSize()), m_Light("Light", GetLightSize()) {
+    // Every shader reads something sensible before the first Set
+    SetCamera(CameraData());
+    SetLight(LightData());
+}
+
+void FrameUniforms::SetCamera(const CameraData& camera) {
+    unsigned char data[s_MaxBlockSize];
+    Std140Writer writer(data, sizeof(data));
+    Pack(writer, camera);
+    m_Camera.SetData(data, writer.GetSize());
+    m_Camera.Bind();
+}
+
+void FrameUniforms::SetLight(const LightData& light) {
+    unsigned char data[s_MaxBlockSize];
+    Std140Writer writer(data, sizeof(data));
+    Pack(writer, light);
+    m_Light.SetData(data, writer.GetSize());
+    m_Light.Bind();
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "UniformBuffer.h"
+#include "glm/glm.hpp"
+
+// Mirror the Camera and Light blocks in res/shaders/Blocks.glsl, member for
+// member. Packing adds the std140 padding, these stay plain structs.
+struct CameraData {
+    glm::mat4 ViewProjection = glm::mat4(1.0f);
+    glm::vec3 Position = glm::vec3(0.0f);
+};
+
+struct LightData {
+    // Towards the scene, doesn't need to be normalized
+    glm::vec3 Direction = glm::vec3(0.0f, 0.0f, -1.0f);
+    glm::vec3 Color = glm::vec3(1.0f);
+    float Ambient = 0.0f;
+};
+
+// The per-frame blocks every shader shares. Set them once a frame, before
+// the frame's draws, and all programs see the same camera and light.
+class FrameUniforms {
+   private:
+    UniformBuffer m_Camera;
+    UniformBuffer m_Light;
+
+   public:
+    FrameUniforms();
+
+    void SetCamera(const CameraData& camera);
+    void SetLight(const LightData& light);
+
+    static unsigned int GetCameraSize();
+    static unsigned int GetLightSize();
+};
@@ -0,0 +1,124 @@
+#include "GLState.h"
+
+#include "Renderer.h"
+
+GLState::GLState() { Invalidate(); }
+
+GLState& GLState::Get() {
+    static thread_local GLState state;
+    return state;
+}
+
+void GLState::Invalidate() {
+    m_Program = Unknown;
+    m_VertexArray = Unknown;
+    m_ArrayBuffer = Unknown;
+    m_ElementBuffers.clear();
+    m_ActiveTextureUnit = Unknown;
+    for (unsigned int& texture : m_Textures) texture = Unknown;
+}
+
+void GLState::UseProgram(unsigned int program) {
+    if (m_Program == program) {
+        m_Stats.Skipped++;
+        return;
+    }
+    GLCall(glUseProgram(program));
+    m_Program = program;
+    m_Stats.Issued++;
+}
+
+void GLState::BindVertexArray(unsigned int vertexArray) {
+    if (m_VertexArray == vertexArray) {
+        m_Stats.Skipped++;
+        return;
+    }
+    GLCall(glBindVertexArray(vertexArray));
+    m_VertexArray = vertexArray;
+    m_Stats.Issued++;
+}
+
+void GLState::BindBuffer(unsigned int target, unsigned int buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        if (m_ArrayBuffer == buffer) {
+            m_Stats.Skipped++;
+            return;
+        }
+        m_ArrayBuffer = buffer;
+    } else if (target == GL_ELEMENT_ARRAY_BUFFER &&
+               m_VertexArray != Unknown) {
+        auto it = m_ElementBuffers.find(m_VertexArray);
+        if (it != m_ElementBuffers.end() && it->second == buffer) {
+            m_Stats.Skipped++;
+            return;
+        }
+        m_ElementBuffers[m_VertexArray] = buffer;
+    }
+    GLCall(glBindBuffer(target, buffer));
+    m_Stats.Issued++;
+}
+
+void GLState::ActiveTexture(unsigned int unit) {
+    if (m_ActiveTextureUnit == unit) {
+        m_Stats.Skipped++;
+        return;
+    }
+    GLCall(glActiveTexture(GL_TEXTURE0 + unit));
+    m_ActiveTextureUnit = unit;
+    m_Stats.Issued++;
+}
+
+void GLState::BindTexture(unsigned int unit, unsigned int texture) {
+    if (unit >= MaxTextureUnits) {
+        ActiveTexture(unit);
+        GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+        m_Stats.Issued++;
+        return;
+    }
+    // Already there, no need to even switch the active unit
+    if (m_Textures[unit] == texture) {
+        m_Stats.Skipped++;
+        return;
+    }
+    ActiveTexture(unit);
+    GLCall(glBindTexture(GL_TEXTURE_2D, texture));
+    m_Textures[unit] = texture;
+    m_Stats.Issued++;
+}
+
+void GLState::BindTextureForEdit(unsigned int unit, unsigned int texture) {
+    // With the unit active the bind below only skips when the texture
+    // really is the one edits go to
+    ActiveTexture(unit);
+    BindTexture(unit, texture);
+}
+
+void GLState::OnDeleteProgram(unsigned int program) {
+    // A deleted program stays in use until another one is bound, but its
+    // name is free to be reused
+    if (m_Program == program) m_Program = Unknown;
+}
+
+void GLState::OnDeleteVertexArray(unsigned int vertexArray) {
+    if (m_VertexArray == vertexArray) m_VertexArray = 0;
+    m_ElementBuffers.erase(vertexArray);
+}
+
+void GLState::OnDeleteBuffer(unsigned int buffer) {
+    if (m_ArrayBuffer == buffer) m_ArrayBuffer = 0;
+    for (auto it = m_ElementBuffers.begin(); it != m_ElementBuffers.end();) {
+        if (it->second == buffer)
+            it = m_ElementBuffers.erase(it);
+        else
+            ++it;
+    }
+}
+
+void GLState::OnDeleteTexture(unsigned int texture) {
+    for (unsigned int& bound : m_Textures)
+        if (bound == texture) bound = 0;
+}
+
+void GLState::OnElementBuffer(unsigned int vertexArray, unsigned int buffer) {
+    m_ElementBuffers[vertexArray] = buffer;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <unordered_map>
+
+// Shadows the GL bindings we touch so a bind of what is already bound
+// never reaches the driver.
+//
+// There is one tracker per thread, which is one per context as long as a
+// context is only current on one thread at a time. Call Invalidate after
+// making another context current or after binding things with raw GL calls.
+class GLState {
+   public:
+    static const unsigned int MaxTextureUnits = 32;
+
+    struct Stats {
+        unsigned int Issued = 0;
+        unsigned int Skipped = 0;
+    };
+
+   private:
+    // Marks a binding we know nothing about, the next bind always goes to GL
+    static const unsigned int Unknown = ~0u;
+
+    unsigned int m_Program;
+    unsigned int m_VertexArray;
+    unsigned int m_ArrayBuffer;
+    // The element buffer binding is part of the vertex array state
+    std::unordered_map<unsigned int, unsigned int> m_ElementBuffers;
+    unsigned int m_ActiveTextureUnit;
+    unsigned int m_Textures[MaxTextureUnits];
+
+    Stats m_Stats;
+
+   public:
+    GLState();
+
+    static GLState& Get();
+
+    void UseProgram(unsigned int program);
+    void BindVertexArray(unsigned int vertexArray);
+    // Only GL_ARRAY_BUFFER and GL_ELEMENT_ARRAY_BUFFER are cached
+    void BindBuffer(unsigned int target, unsigned int buffer);
+    void ActiveTexture(unsigned int unit);
+    // Binds a GL_TEXTURE_2D to the given unit, for sampling. When it is
+    // already there nothing is called, and the active unit may still be
+    // another one.
+    void BindTexture(unsigned int unit, unsigned int texture);
+    // Same, but unit is always left active, so glTexImage2D and friends,
+    // which act on the active unit, reach this texture
+    void BindTextureForEdit(unsigned int unit, unsigned int texture);
+
+    // GL drops bindings of deleted objects and may hand the name out again,
+    // so the cache has to forget them too
+    void OnDeleteProgram(unsigned int program);
+    void OnDeleteVertexArray(unsigned int vertexArray);
+    void OnDeleteBuffer(unsigned int buffer);
+    void OnDeleteTexture(unsigned int texture);
+    // An element buffer attached to a vertex array by name (DSA), without
+    // binding either of them
+    void OnElementBuffer(unsigned int vertexArray, unsigned int buffer);
+
+    void Invalidate();
+
+    inline const Stats& GetStats() const { return m_Stats; }
+    inline void ResetStats() { m_Stats = Stats(); }
+};
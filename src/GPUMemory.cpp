@@ -0,0 +1,228 @@
+#include "GPUMemory.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+const char* GetCategoryName(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::VertexBuffer:
+            return "vertex buffers";
+        case MemoryCategory::IndexBuffer:
+            return "index buffers";
+        case MemoryCategory::IndirectBuffer:
+            return "indirect buffers";
+        case MemoryCategory::StreamingBuffer:
+            return "streaming buffers";
+        case MemoryCategory::UniformBuffer:
+            return "uniform buffers";
+        case MemoryCategory::Texture:
+            return "textures";
+        case MemoryCategory::RenderTarget:
+            return "render targets";
+        case MemoryCategory::Count:
+            break;
+    }
+    return "unknown";
+}
+
+// Bytes, KB or MB with one decimal, enough to spot trends in a log
+static void PrintSize(std::ostream& out, std::size_t bytes) {
+    // Leave the stream's formatting as it was for whoever prints next
+    std::ios::fmtflags flags = out.flags();
+    std::streamsize precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    if (bytes < 1024)
+        out << bytes << " B";
+    else if (bytes < 1024 * 1024)
+        out << bytes / 1024.0 << " KB";
+    else
+        out << bytes / (1024.0 * 1024.0) << " MB";
+    out.flags(flags);
+    out.precision(precision);
+}
+
+GPUMemory::GPUMemory()
+    : m_Total(0),
+      m_Peak(0),
+      m_Budget(0),
+      m_OverBudget(false),
+      m_LogInterval(0.0),
+      m_LastLog(Clock::now()) {}
+
+GPUMemory& GPUMemory::Get() {
+    static GPUMemory s_Memory;
+    return s_Memory;
+}
+
+void GPUMemory::Track(MemoryCategory category, unsigned int id,
+                      std::size_t bytes) {
+    if (!id) return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    unsigned int index = static_cast<unsigned int>(category);
+    auto inserted = m_Allocations.insert({{index, id}, Allocation()});
+    Allocation& allocation = inserted.first->second;
+    if (inserted.second)
+        m_Categories[index].Objects++;
+    else
+        Remove(index, allocation.Bytes);
+    allocation.Bytes = bytes;
+    Add(index, bytes);
+}
+
+void GPUMemory::Untrack(MemoryCategory category, unsigned int id) {
+    if (!id) return;
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    unsigned int index = static_cast<unsigned int>(category);
+    auto it = m_Allocations.find({index, id});
+    if (it == m_Allocations.end()) return;
+
+    Remove(index, it->second.Bytes);
+    m_Categories[index].Objects--;
+    m_Allocations.erase(it);
+    if (m_Total <= m_Budget) m_OverBudget = false;
+}
+
+void GPUMemory::SetName(MemoryCategory category, unsigned int id,
+                        const std::string& name) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto it = m_Allocations.find({static_cast<unsigned int>(category), id});
+    if (it != m_Allocations.end()) it->second.Name = name;
+}
+
+std::size_t GPUMemory::GetTotal() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Total;
+}
+
+std::size_t GPUMemory::GetPeak() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Peak;
+}
+
+GPUMemory::Usage GPUMemory::GetUsage(MemoryCategory category) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Categories[static_cast<unsigned int>(category)];
+}
+
+std::map<std::string, GPUMemory::Usage> GPUMemory::GetUsageByName() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    std::map<std::string, Usage> usage;
+    for (const auto& entry : m_Allocations) {
+        Usage& named = usage[entry.second.Name];
+        named.Bytes += entry.second.Bytes;
+        named.Objects++;
+    }
+    return usage;
+}
+
+void GPUMemory::SetBudget(std::size_t bytes) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Budget = bytes;
+    m_OverBudget = false;
+}
+
+void GPUMemory::SetLogInterval(double seconds) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_LogInterval = seconds;
+    m_LastLog = Clock::now();
+}
+
+void GPUMemory::Update() {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_LogInterval <= 0.0) return;
+
+    Clock::time_point now = Clock::now();
+    std::chrono::duration<double> elapsed = now - m_LastLog;
+    if (elapsed.count() < m_LogInterval) return;
+
+    m_LastLog = now;
+    PrintLocked(std::cout);
+}
+
+void GPUMemory::Print(std::ostream& out) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    PrintLocked(out);
+}
+
+void GPUMemory::PrintByName(std::ostream& out) {
+    std::map<std::string, Usage> usage = GetUsageByName();
+    std::vector<std::pair<std::string, Usage>> sorted(usage.begin(),
+                                                      usage.end());
+    std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+        return a.second.Bytes > b.second.Bytes;
+    });
+
+    for (const auto& entry : sorted) {
+        out << "  " << (entry.first.empty() ? "(unnamed)" : entry.first)
+            << ": ";
+        PrintSize(out, entry.second.Bytes);
+        out << " in " << entry.second.Objects << " objects\n";
+    }
+}
+
+std::size_t GPUMemory::GetTextureSize(int width, int height,
+                                      int bytesPerPixel, int levels) {
+    std::size_t size = 0;
+    for (int level = 0; level < levels; ++level) {
+        size += (std::size_t)width * height * bytesPerPixel;
+        width = std::max(width / 2, 1);
+        height = std::max(height / 2, 1);
+    }
+    return size;
+}
+
+int GPUMemory::GetMipLevels(int width, int height) {
+    int levels = 1;
+    for (int size = std::max(width, height); size > 1; size /= 2) levels++;
+    return levels;
+}
+
+void GPUMemory::Add(unsigned int category, std::size_t bytes) {
+    m_Categories[category].Bytes += bytes;
+    m_Total += bytes;
+    m_Peak = std::max(m_Peak, m_Total);
+
+    // Warn again the next time the budget is exceeded
+    if (m_Total <= m_Budget) m_OverBudget = false;
+
+    if (m_Budget && m_Total > m_Budget && !m_OverBudget) {
+        m_OverBudget = true;
+        std::cout << "Warning: GPU memory over budget, ";
+        PrintSize(std::cout, m_Total);
+        std::cout << " of ";
+        PrintSize(std::cout, m_Budget);
+        std::cout << " after " << bytes << " more bytes of "
+                  << GetCategoryName(static_cast<MemoryCategory>(category))
+                  << '\n';
+    }
+}
+
+void GPUMemory::Remove(unsigned int category, std::size_t bytes) {
+    m_Categories[category].Bytes -= bytes;
+    m_Total -= bytes;
+}
+
+void GPUMemory::PrintLocked(std::ostream& out) {
+    out << "GPU memory: ";
+    PrintSize(out, m_Total);
+    out << " (peak ";
+    PrintSize(out, m_Peak);
+    if (m_Budget) {
+        out << ", budget ";
+        PrintSize(out, m_Budget);
+    }
+    out << ")";
+
+    for (unsigned int category = 0; category < CategoryCount; ++category) {
+        const Usage& usage = m_Categories[category];
+        if (!usage.Objects) continue;
+        out << ", " << GetCategoryName(static_cast<MemoryCategory>(category))
+            << ' ';
+        PrintSize(out, usage.Bytes);
+    }
+    out << '\n';
+}
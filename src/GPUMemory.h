@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <utility>
+
+enum class MemoryCategory {
+    VertexBuffer,
+    IndexBuffer,
+    IndirectBuffer,
+    StreamingBuffer,
+    UniformBuffer,
+    Texture,
+    RenderTarget,
+    Count
+};
+
+const char* GetCategoryName(MemoryCategory category);
+
+// Bytes the app has asked GL to allocate, by category and by debug name.
+// GL can't tell us what the driver really uses (padding, alignment, its own
+// copies), so this is what we requested, which is what we can act on.
+// Resources report their storage whenever they (re)allocate it and stop
+// being tracked when they are destroyed.
+class GPUMemory {
+   public:
+    struct Usage {
+        std::size_t Bytes = 0;
+        unsigned int Objects = 0;
+    };
+
+   private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Allocation {
+        std::size_t Bytes = 0;
+        std::string Name;
+    };
+
+    static const unsigned int CategoryCount =
+        static_cast<unsigned int>(MemoryCategory::Count);
+
+    // Resources may be destroyed on any thread
+    std::mutex m_Mutex;
+    // Keyed by category too, buffers, textures and framebuffers have
+    // separate name spaces
+    std::map<std::pair<unsigned int, unsigned int>, Allocation> m_Allocations;
+    Usage m_Categories[CategoryCount];
+    std::size_t m_Total;
+    std::size_t m_Peak;
+
+    // 0 means no budget
+    std::size_t m_Budget;
+    bool m_OverBudget;
+
+    // 0 means no periodic log
+    double m_LogInterval;
+    Clock::time_point m_LastLog;
+
+   public:
+    GPUMemory();
+
+    static GPUMemory& Get();
+
+    // The object now holds bytes, replacing what it held before. Name 0 is
+    // ignored, that is what moved-from resources hold.
+    void Track(MemoryCategory category, unsigned int id, std::size_t bytes);
+    void Untrack(MemoryCategory category, unsigned int id);
+    // Groups the object under name in GetUsageByName and the log
+    void SetName(MemoryCategory category, unsigned int id,
+                 const std::string& name);
+
+    std::size_t GetTotal();
+    std::size_t GetPeak();
+    Usage GetUsage(MemoryCategory category);
+    // Objects without a name are grouped under ""
+    std::map<std::string, Usage> GetUsageByName();
+
+    // Warns once every time the total goes over bytes, 0 turns it off
+    void SetBudget(std::size_t bytes);
+    // Seconds between log lines written by Update, 0 turns it off
+    void SetLogInterval(double seconds);
+
+    // Call once per frame, writes the log line when it is due
+    void Update();
+    // One line with the total and the categories in use
+    void Print(std::ostream& out);
+    // One line per debug name, largest first
+    void PrintByName(std::ostream& out);
+
+    // All mip levels of a width x height image, each half the size of the
+    // one before down to 1x1
+    static std::size_t GetTextureSize(int width, int height,
+                                      int bytesPerPixel, int levels);
+    // Levels of a full mip chain for the image
+    static int GetMipLevels(int width, int height);
+
+   private:
+    // Called with m_Mutex held
+    void Add(unsigned int category, std::size_t bytes);
+    void Remove(unsigned int category, std::size_t bytes);
+    void PrintLocked(std::ostream& out);
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// FNV-1a, 64 bit. Stable across runs and platforms unlike std::hash, so it
+// can key things that are saved to disk, and constexpr so names can be
+// hashed at compile time.
+static constexpr uint64_t FNVOffsetBasis = 0xcbf29ce484222325ull;
+static constexpr uint64_t FNVPrime = 0x100000001b3ull;
+
+constexpr uint64_t HashFNV1a(const char* data, std::size_t size,
+                             uint64_t hash = FNVOffsetBasis) {
+    for (std::size_t i = 0; i < size; ++i) {
+        hash ^= (unsigned char)data[i];
+        hash *= FNVPrime;
+    }
+    return hash;
+}
+
+inline uint64_t HashFNV1a(const std::string& data,
+                          uint64_t hash = FNVOffsetBasis) {
+    return HashFNV1a(data.data(), data.size(), hash);
+}
@@ -0,0 +1,238 @@
+#include "HeadlessContext.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "Renderer.h"
+
+#if defined(HEADLESS_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#elif defined(HEADLESS_OSMESA)
+#include <GL/osmesa.h>
+#endif
+
+HeadlessContext::HeadlessContext()
+    : m_Display(nullptr),
+      m_Config(nullptr),
+      m_Context(nullptr),
+      m_Surface(nullptr),
+      m_OwnsDisplay(false),
+      m_Buffer(nullptr),
+      m_Width(0),
+      m_Height(0) {}
+
+bool HeadlessContext::IsAvailable() {
+#if defined(HEADLESS_EGL) || defined(HEADLESS_OSMESA)
+    return true;
+#else
+    return false;
+#endif
+}
+
+#if defined(HEADLESS_EGL)
+
+static bool HasExtension(EGLDisplay display, const char* name) {
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    return extensions && strstr(extensions, name);
+}
+
+// Same version and profile the windowed app asks GLFW for
+static const EGLint s_ContextAttribs[] = {
+    EGL_CONTEXT_MAJOR_VERSION, 3,
+    EGL_CONTEXT_MINOR_VERSION, 3,
+    EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+    EGL_NONE};
+
+bool HeadlessContext::Create(int width, int height) {
+    m_Width = width;
+    m_Height = height;
+
+    // The surfaceless platform needs no X server, DRM device or GPU at all
+    EGLDisplay display = EGL_NO_DISPLAY;
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)
+        eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (getPlatformDisplay)
+        display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                     EGL_DEFAULT_DISPLAY, nullptr);
+    if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, nullptr, nullptr)) {
+        std::cout << "Failed to initialize EGL\n";
+        return false;
+    }
+    m_Display = display;
+    m_OwnsDisplay = true;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        std::cout << "EGL has no desktop OpenGL support\n";
+        return false;
+    }
+
+    bool surfaceless = HasExtension(display, "EGL_KHR_surfaceless_context");
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfaceless ? 0 : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE};
+    EGLConfig config;
+    EGLint configCount;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) ||
+        configCount == 0) {
+        std::cout << "No suitable EGL config\n";
+        return false;
+    }
+    m_Config = config;
+
+    m_Context =
+        eglCreateContext(display, config, EGL_NO_CONTEXT, s_ContextAttribs);
+    if (m_Context == EGL_NO_CONTEXT) {
+        std::cout << "Failed to create EGL context\n";
+        return false;
+    }
+
+    // Without surfaceless contexts we need something to make current
+    if (!surfaceless) {
+        const EGLint surfaceAttribs[] = {EGL_WIDTH, m_Width, EGL_HEIGHT,
+                                         m_Height, EGL_NONE};
+        m_Surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+    }
+
+    MakeCurrent();
+
+    // GLEW built for GLX reports a missing X display after it has already
+    // loaded every GL entry point, that is fine for us
+    glewExperimental = GL_TRUE;
+    GLenum error = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (error == GLEW_ERROR_NO_GLX_DISPLAY) error = GLEW_OK;
+#endif
+    if (error != GLEW_OK) {
+        std::cout << "Failed to initialize GLEW: " << glewGetErrorString(error)
+                  << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessContext::CreateShared(const HeadlessContext& main) {
+    m_Display = main.m_Display;
+    m_Config = main.m_Config;
+    m_Width = m_Height = 1;
+
+    // Binding the API is per thread, the worker does it before MakeCurrent
+    eglBindAPI(EGL_OPENGL_API);
+    m_Context = eglCreateContext((EGLDisplay)m_Display, (EGLConfig)m_Config,
+                                 (EGLContext)main.m_Context, s_ContextAttribs);
+    if (m_Context == EGL_NO_CONTEXT) {
+        std::cout << "Failed to create shared EGL context\n";
+        return false;
+    }
+
+    if (main.m_Surface) {
+        const EGLint surfaceAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1,
+                                         EGL_NONE};
+        m_Surface = eglCreatePbufferSurface((EGLDisplay)m_Display,
+                                            (EGLConfig)m_Config,
+                                            surfaceAttribs);
+    }
+    return true;
+}
+
+void HeadlessContext::MakeCurrent() {
+    eglBindAPI(EGL_OPENGL_API);
+    EGLSurface surface = m_Surface ? (EGLSurface)m_Surface : EGL_NO_SURFACE;
+    eglMakeCurrent((EGLDisplay)m_Display, surface, surface,
+                   (EGLContext)m_Context);
+}
+
+void HeadlessContext::ReleaseCurrent() {
+    eglMakeCurrent((EGLDisplay)m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+}
+
+HeadlessContext::~HeadlessContext() {
+    if (!m_Display) return;
+    if (m_OwnsDisplay) ReleaseCurrent();
+    if (m_Surface) eglDestroySurface((EGLDisplay)m_Display, m_Surface);
+    if (m_Context) eglDestroyContext((EGLDisplay)m_Display, m_Context);
+    if (m_OwnsDisplay) eglTerminate((EGLDisplay)m_Display);
+}
+
+#elif defined(HEADLESS_OSMESA)
+
+static const int s_ContextAttribs[] = {
+    OSMESA_FORMAT,                OSMESA_RGBA,
+    OSMESA_DEPTH_BITS,            24,
+    OSMESA_PROFILE,               OSMESA_CORE_PROFILE,
+    OSMESA_CONTEXT_MAJOR_VERSION, 3,
+    OSMESA_CONTEXT_MINOR_VERSION, 3,
+    0};
+
+bool HeadlessContext::Create(int width, int height) {
+    m_Width = width;
+    m_Height = height;
+
+    m_Context = OSMesaCreateContextAttribs(s_ContextAttribs, nullptr);
+    if (!m_Context) {
+        std::cout << "Failed to create OSMesa context\n";
+        return false;
+    }
+
+    // OSMesa needs a color buffer even if we only render into FrameBuffers
+    m_Buffer = new unsigned char[m_Width * m_Height * 4];
+    MakeCurrent();
+
+    glewExperimental = GL_TRUE;
+    GLenum error = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+    if (error == GLEW_ERROR_NO_GLX_DISPLAY) error = GLEW_OK;
+#endif
+    if (error != GLEW_OK) {
+        std::cout << "Failed to initialize GLEW: " << glewGetErrorString(error)
+                  << '\n';
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessContext::CreateShared(const HeadlessContext& main) {
+    m_Width = m_Height = 1;
+    m_Context = OSMesaCreateContextAttribs(s_ContextAttribs,
+                                           (OSMesaContext)main.m_Context);
+    if (!m_Context) {
+        std::cout << "Failed to create shared OSMesa context\n";
+        return false;
+    }
+    m_Buffer = new unsigned char[4];
+    return true;
+}
+
+void HeadlessContext::MakeCurrent() {
+    OSMesaMakeCurrent((OSMesaContext)m_Context, m_Buffer, GL_UNSIGNED_BYTE,
+                      m_Width, m_Height);
+}
+
+void HeadlessContext::ReleaseCurrent() {
+    OSMesaMakeCurrent(nullptr, nullptr, GL_UNSIGNED_BYTE, 0, 0);
+}
+
+HeadlessContext::~HeadlessContext() {
+    if (m_Context) OSMesaDestroyContext((OSMesaContext)m_Context);
+    delete[] m_Buffer;
+}
+
+#else
+
+bool HeadlessContext::Create(int, int) {
+    std::cout << "This build has no headless backend, rebuild with "
+                 "HEADLESS=egl or HEADLESS=osmesa\n";
+    return false;
+}
+
+bool HeadlessContext::CreateShared(const HeadlessContext&) { return false; }
+
+void HeadlessContext::MakeCurrent() {}
+void HeadlessContext::ReleaseCurrent() {}
+HeadlessContext::~HeadlessContext() {}
+
+#endif
@@ -0,0 +1,34 @@
+#pragma once
+
+// A GL 3.3 core context without a window, for machines with no display or
+// GPU (CI, render farms). Uses EGL surfaceless when built with HEADLESS_EGL
+// and OSMesa when built with HEADLESS_OSMESA, both run on Mesa's llvmpipe.
+// There is no default framebuffer, render into a FrameBuffer instead.
+class HeadlessContext {
+   private:
+    void* m_Display;
+    void* m_Config;
+    void* m_Context;
+    void* m_Surface;
+    // Shared contexts use the display of the one they share with
+    bool m_OwnsDisplay;
+    // OSMesa renders into memory we own
+    unsigned char* m_Buffer;
+    int m_Width, m_Height;
+
+   public:
+    HeadlessContext();
+    ~HeadlessContext();
+
+    // Creates the context, makes it current and initializes GLEW
+    bool Create(int width, int height);
+    // A second context sharing buffers, textures and programs with main,
+    // for a worker thread. Not made current, main must be created already.
+    bool CreateShared(const HeadlessContext& main);
+
+    void MakeCurrent();
+    void ReleaseCurrent();
+
+    // False if this build has no headless backend
+    static bool IsAvailable();
+};
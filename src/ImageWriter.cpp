@@ -0,0 +1,104 @@
+#include "ImageWriter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <vector>
+
+// Just enough PNG for regression images: one IDAT with the zlib stream made
+// of stored (uncompressed) deflate blocks, filter type 0 on every row.
+// Files are bigger than they need to be, but there's nothing to get wrong.
+
+static unsigned int Crc32(const unsigned char* data, size_t size,
+                          unsigned int crc = 0) {
+    static unsigned int table[256];
+    if (!table[1]) {
+        for (unsigned int i = 0; i < 256; ++i) {
+            unsigned int c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+static unsigned int Adler32(const unsigned char* data, size_t size) {
+    unsigned int a = 1, b = 0;
+    for (size_t i = 0; i < size; ++i) {
+        a = (a + data[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+}
+
+static void PushBigEndian(std::vector<unsigned char>& out, unsigned int value) {
+    out.push_back(value >> 24);
+    out.push_back(value >> 16);
+    out.push_back(value >> 8);
+    out.push_back(value);
+}
+
+static void WriteChunk(std::ofstream& file, const char* type,
+                       const std::vector<unsigned char>& data) {
+    std::vector<unsigned char> chunk;
+    PushBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    // The CRC covers the type and the data, not the length
+    PushBigEndian(chunk, Crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+bool WritePNG(const std::string& path, int width, int height,
+              const unsigned char* rgba, bool flipVertically) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    const unsigned char signature[] = {0x89, 'P',  'N',  'G',
+                                       '\r', '\n', 0x1a, '\n'};
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<unsigned char> header;
+    PushBigEndian(header, width);
+    PushBigEndian(header, height);
+    header.push_back(8);  // Bits per channel
+    header.push_back(6);  // Color type RGBA
+    header.push_back(0);  // Deflate
+    header.push_back(0);  // Adaptive filtering
+    header.push_back(0);  // Not interlaced
+    WriteChunk(file, "IHDR", header);
+
+    // Every row starts with its filter type, 0 is none
+    size_t rowSize = width * 4;
+    std::vector<unsigned char> raw;
+    raw.reserve((rowSize + 1) * height);
+    for (int y = 0; y < height; ++y) {
+        int row = flipVertically ? height - 1 - y : y;
+        raw.push_back(0);
+        raw.insert(raw.end(), rgba + row * rowSize, rgba + (row + 1) * rowSize);
+    }
+
+    std::vector<unsigned char> zlib = {0x78, 0x01};
+    // Stored blocks hold at most 65535 bytes each
+    size_t offset = 0;
+    do {
+        size_t size = std::min<size_t>(65535, raw.size() - offset);
+        bool last = offset + size == raw.size();
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(size & 0xff);
+        zlib.push_back(size >> 8);
+        zlib.push_back(~size & 0xff);
+        zlib.push_back((~size >> 8) & 0xff);
+        zlib.insert(zlib.end(), raw.begin() + offset,
+                    raw.begin() + offset + size);
+        offset += size;
+    } while (offset < raw.size());
+    PushBigEndian(zlib, Adler32(raw.data(), raw.size()));
+    WriteChunk(file, "IDAT", zlib);
+
+    WriteChunk(file, "IEND", {});
+    return file.good();
+}
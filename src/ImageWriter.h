@@ -0,0 +1,8 @@
+#pragma once
+
+#include <string>
+
+// Writes 8-bit RGBA pixels as an uncompressed PNG. flipVertically turns
+// GL's bottom-up rows into the top-down order image files use.
+bool WritePNG(const std::string& path, int width, int height,
+              const unsigned char* rgba, bool flipVertically = true);
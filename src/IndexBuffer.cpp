@@ -1,24 +1,184 @@
 #include "IndexBuffer.h"
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "GPUMemory.h"
 #include "Renderer.h"
 
 // Generating index buffers
 // Type should always be unsigned!
 
-IndexBuffer::IndexBuffer(const unsigned int *data, unsigned int count)
-    : m_Count(count) {
-    GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int),
-                        data, GL_STATIC_DRAW));
+static uint32_t MaxIndex(const uint32_t *data, unsigned int count) {
+    return count ? *std::max_element(data, data + count) : 0;
+}
+
+// Smallest type that holds every index, see the header for why not bytes
+static IndexType PickType(uint32_t maxIndex) {
+    return maxIndex <= 0xffff ? IndexType::UInt16 : IndexType::UInt32;
 }
 
-IndexBuffer::~IndexBuffer() { GLCall(glDeleteBuffers(1, &m_RendererID)); }
+// 32-bit indices in the layout of type, data itself if nothing changes
+static const void *Narrow(const uint32_t *data, unsigned int count,
+                          IndexType type,
+                          std::vector<unsigned char> &storage) {
+    if (type == IndexType::UInt32) return data;
+
+    storage.resize(count * IndexBuffer::GetIndexSize(type));
+    if (type == IndexType::UInt16) {
+        uint16_t *narrow = reinterpret_cast<uint16_t *>(storage.data());
+        for (unsigned int i = 0; i < count; ++i) {
+            ASSERT(data[i] <= 0xffff);
+            narrow[i] = (uint16_t)data[i];
+        }
+    } else {
+        for (unsigned int i = 0; i < count; ++i) {
+            ASSERT(data[i] <= 0xff);
+            storage[i] = (uint8_t)data[i];
+        }
+    }
+    return storage.data();
+}
+
+IndexBuffer::IndexBuffer(const uint32_t *data, unsigned int count,
+                         BufferUsage usage)
+    : m_Count(count),
+      m_Capacity(count),
+      m_Usage(usage),
+      m_Type(PickType(MaxIndex(data, count))) {
+    std::vector<unsigned char> storage;
+    Create(Narrow(data, count, m_Type, storage), count);
+}
+
+IndexBuffer::IndexBuffer(const uint16_t *data, unsigned int count,
+                         BufferUsage usage)
+    : m_Count(count),
+      m_Capacity(count),
+      m_Usage(usage),
+      m_Type(IndexType::UInt16) {
+    Create(data, count);
+}
+
+IndexBuffer::IndexBuffer(const uint8_t *data, unsigned int count,
+                         BufferUsage usage)
+    : m_Count(count),
+      m_Capacity(count),
+      m_Usage(usage),
+      m_Type(IndexType::UInt8) {
+    Create(data, count);
+}
+
+IndexBuffer::IndexBuffer(unsigned int capacity, IndexType type,
+                         BufferUsage usage)
+    : m_Count(0), m_Capacity(capacity), m_Usage(usage), m_Type(type) {
+    m_RendererID = BufferCreate();
+    BufferAllocate(m_RendererID, capacity * GetIndexSize(), usage);
+    GPUMemory::Get().Track(MemoryCategory::IndexBuffer, m_RendererID,
+                           capacity * GetIndexSize());
+}
+
+void IndexBuffer::Create(const void *data, unsigned int count) {
+    m_RendererID = BufferCreate();
+    GPUMemory::Get().Track(MemoryCategory::IndexBuffer, m_RendererID,
+                           count * GetIndexSize());
+    if (GLHasDirectStateAccess()) {
+        BufferAllocate(m_RendererID, count * GetIndexSize(), m_Usage, data);
+        return;
+    }
+    // Also attaches the buffer to the bound vertex array, which code written
+    // before SetIndexBuffer existed relies on
+    Bind();
+    GLCall(glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * GetIndexSize(), data,
+                        static_cast<GLenum>(m_Usage)));
+}
+
+IndexBuffer::~IndexBuffer() {
+    GPUMemory::Get().Untrack(MemoryCategory::IndexBuffer, m_RendererID);
+    DeletionQueue::Get().Push(GLObjectType::Buffer, m_RendererID);
+}
+
+IndexBuffer::IndexBuffer(IndexBuffer &&other) noexcept
+    : m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_Count(other.m_Count),
+      m_Capacity(other.m_Capacity),
+      m_Usage(other.m_Usage),
+      m_Type(other.m_Type) {}
+
+// Our old buffer goes to other and is deleted along with it
+IndexBuffer &IndexBuffer::operator=(IndexBuffer &&other) noexcept {
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_Count, other.m_Count);
+    std::swap(m_Capacity, other.m_Capacity);
+    std::swap(m_Usage, other.m_Usage);
+    std::swap(m_Type, other.m_Type);
+    return *this;
+}
 
 void IndexBuffer::Bind() const {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID));
+    GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 }
 
 void IndexBuffer::Unbind() const {
-    GLCall(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
-}
\ No newline at end of file
+    GLState::Get().BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// Updates go through the helpers in BufferUsage.h, binding to
+// GL_ELEMENT_ARRAY_BUFFER would change the index buffer of whatever vertex
+// array happens to be bound
+
+void IndexBuffer::SetData(const uint32_t *data, unsigned int count) {
+    // Nothing is kept, so the type is free to change. Byte buffers were
+    // asked for explicitly and stay bytes while the data fits.
+    uint32_t maxIndex = MaxIndex(data, count);
+    if (m_Type != IndexType::UInt8 || maxIndex > 0xff)
+        m_Type = PickType(maxIndex);
+
+    if (count > m_Capacity) m_Capacity = GrowCapacity(m_Capacity, count);
+    std::vector<unsigned char> storage;
+    BufferAllocate(m_RendererID, m_Capacity * GetIndexSize(), m_Usage);
+    GPUMemory::Get().Track(MemoryCategory::IndexBuffer, m_RendererID,
+                           m_Capacity * GetIndexSize());
+    BufferWrite(m_RendererID, 0, count * GetIndexSize(),
+                Narrow(data, count, m_Type, storage));
+    m_Count = count;
+}
+
+void IndexBuffer::Update(const uint32_t *data, unsigned int count,
+                         unsigned int offset) {
+    if (offset + count > m_Capacity)
+        Reserve(GrowCapacity(m_Capacity, offset + count));
+    std::vector<unsigned char> storage;
+    BufferWrite(m_RendererID, offset * GetIndexSize(), count * GetIndexSize(),
+                Narrow(data, count, m_Type, storage));
+    if (offset + count > m_Count) m_Count = offset + count;
+}
+
+void IndexBuffer::Reserve(unsigned int capacity) {
+    if (capacity <= m_Capacity) return;
+    // Written ranges may lie past m_Count, keep the whole old storage
+    BufferReallocate(m_RendererID, capacity * GetIndexSize(), m_Usage,
+                     m_Capacity * GetIndexSize());
+    m_Capacity = capacity;
+    GPUMemory::Get().Track(MemoryCategory::IndexBuffer, m_RendererID,
+                           capacity * GetIndexSize());
+}
+
+void IndexBuffer::SetDebugName(const std::string &name) {
+    GPUMemory::Get().SetName(MemoryCategory::IndexBuffer, m_RendererID, name);
+}
+
+unsigned int IndexBuffer::GetIndexSize(IndexType type) {
+    switch (type) {
+        case IndexType::UInt8:
+            return 1;
+        case IndexType::UInt16:
+            return 2;
+        case IndexType::UInt32:
+            return 4;
+    }
+    ASSERT(false);
+    return 0;
+}
@@ -1,16 +1,76 @@
 #pragma once
 
+#include <cstdint>
+#include <string>
+
+#include "BufferUsage.h"
+
+// Size of one index. The values are the GL enums glDrawElements takes.
+enum class IndexType : unsigned int {
+    UInt8 = 0x1401,   // GL_UNSIGNED_BYTE
+    UInt16 = 0x1403,  // GL_UNSIGNED_SHORT
+    UInt32 = 0x1405,  // GL_UNSIGNED_INT
+};
+
 class IndexBuffer {
    private:
     unsigned int m_RendererID;
     unsigned int m_Count;
+    // Indices the storage can hold without growing
+    unsigned int m_Capacity;
+    BufferUsage m_Usage;
+    IndexType m_Type;
 
    public:
-    IndexBuffer(const unsigned int *data, unsigned int count);
+    // 32-bit input is stored as 16-bit when the largest index fits, halving
+    // the memory and the bandwidth the GPU spends fetching indices
+    IndexBuffer(const uint32_t *data, unsigned int count,
+                BufferUsage usage = BufferUsage::Static);
+    IndexBuffer(const uint16_t *data, unsigned int count,
+                BufferUsage usage = BufferUsage::Static);
+    // Byte indices are never picked automatically, some GPUs convert them
+    // on the CPU on every draw
+    IndexBuffer(const uint8_t *data, unsigned int count,
+                BufferUsage usage = BufferUsage::Static);
+    // Storage for capacity indices, GetCount is 0 until data is written
+    IndexBuffer(unsigned int capacity, IndexType type = IndexType::UInt32,
+                BufferUsage usage = BufferUsage::Dynamic);
     ~IndexBuffer();
 
+    // Move-only, a copy would delete the GL object twice
+    IndexBuffer(const IndexBuffer &) = delete;
+    IndexBuffer &operator=(const IndexBuffer &) = delete;
+    IndexBuffer(IndexBuffer &&other) noexcept;
+    IndexBuffer &operator=(IndexBuffer &&other) noexcept;
+
     void Bind() const;
     void Unbind() const;
 
+    // Replaces all indices, orphaning the old storage first. The index type
+    // is picked again from the new data.
+    void SetData(const uint32_t *data, unsigned int count);
+    // Writes count indices starting at index offset, growing if needed. The
+    // type is kept, every index must fit in it.
+    void Update(const uint32_t *data, unsigned int count,
+                unsigned int offset = 0);
+    // Grows the storage to hold at least capacity indices, keeping them
+    void Reserve(unsigned int capacity);
+
+    // Name the buffer's memory is reported under, see GPUMemory
+    void SetDebugName(const std::string &name);
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
     inline unsigned int GetCount() const { return m_Count; }
-};
\ No newline at end of file
+    inline unsigned int GetCapacity() const { return m_Capacity; }
+    inline BufferUsage GetUsage() const { return m_Usage; }
+    // GL enum for glDrawElements and friends
+    inline unsigned int GetType() const {
+        return static_cast<unsigned int>(m_Type);
+    }
+    inline unsigned int GetIndexSize() const { return GetIndexSize(m_Type); }
+
+    static unsigned int GetIndexSize(IndexType type);
+
+   private:
+    void Create(const void *data, unsigned int count);
+};
@@ -0,0 +1,74 @@
+#include "IndirectBuffer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "GPUMemory.h"
+#include "Renderer.h"
+
+bool IndirectBuffer::IsSupported() {
+    return GLEW_ARB_multi_draw_indirect;
+}
+
+IndirectBuffer::IndirectBuffer() : m_RendererID(0), m_Capacity(0) {
+    if (IsSupported()) {
+        GLCall(glGenBuffers(1, &m_RendererID));
+    }
+}
+
+IndirectBuffer::~IndirectBuffer() {
+    GPUMemory::Get().Untrack(MemoryCategory::IndirectBuffer, m_RendererID);
+    DeletionQueue::Get().Push(GLObjectType::Buffer, m_RendererID);
+}
+
+IndirectBuffer::IndirectBuffer(IndirectBuffer&& other) noexcept
+    : m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_Commands(std::move(other.m_Commands)),
+      m_Capacity(std::exchange(other.m_Capacity, 0)) {}
+
+// Our old buffer goes to other and is deleted along with it
+IndirectBuffer& IndirectBuffer::operator=(IndirectBuffer&& other) noexcept {
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_Commands, other.m_Commands);
+    std::swap(m_Capacity, other.m_Capacity);
+    return *this;
+}
+
+void IndirectBuffer::Add(unsigned int count, unsigned int firstIndex,
+                         int baseVertex, unsigned int baseInstance,
+                         unsigned int instanceCount) {
+    m_Commands.push_back(
+        {count, instanceCount, firstIndex, baseVertex, baseInstance});
+}
+
+void IndirectBuffer::Clear() { m_Commands.clear(); }
+
+void IndirectBuffer::Upload() {
+    if (!m_RendererID || m_Commands.empty()) return;
+
+    Bind();
+    unsigned int size = m_Commands.size() * sizeof(DrawElementsIndirectCommand);
+    if (m_Commands.size() > m_Capacity) {
+        // Grow geometrically so adding a few draws doesn't reallocate
+        // every frame
+        m_Capacity = std::max<unsigned int>(m_Commands.size(), m_Capacity * 2);
+        GLCall(glBufferData(GL_DRAW_INDIRECT_BUFFER,
+                            m_Capacity * sizeof(DrawElementsIndirectCommand),
+                            nullptr, GL_DYNAMIC_DRAW));
+        GPUMemory::Get().Track(
+            MemoryCategory::IndirectBuffer, m_RendererID,
+            m_Capacity * sizeof(DrawElementsIndirectCommand));
+    }
+    GLCall(glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, size,
+                           m_Commands.data()));
+}
+
+void IndirectBuffer::Bind() const {
+    GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_RendererID));
+}
+
+void IndirectBuffer::Unbind() const {
+    GLCall(glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0));
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+// Layout glMultiDrawElementsIndirect expects for every draw
+struct DrawElementsIndirectCommand {
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int baseVertex;
+    unsigned int baseInstance;
+};
+
+// Draw records filled on the CPU and uploaded into a GL_DRAW_INDIRECT_BUFFER,
+// so all of them can be submitted with one call
+class IndirectBuffer {
+   private:
+    unsigned int m_RendererID;
+    std::vector<DrawElementsIndirectCommand> m_Commands;
+    // How many commands the GL buffer can hold
+    unsigned int m_Capacity;
+
+   public:
+    IndirectBuffer();
+    ~IndirectBuffer();
+
+    // Move-only, a copy would delete the GL object twice
+    IndirectBuffer(const IndirectBuffer&) = delete;
+    IndirectBuffer& operator=(const IndirectBuffer&) = delete;
+    IndirectBuffer(IndirectBuffer&& other) noexcept;
+    IndirectBuffer& operator=(IndirectBuffer&& other) noexcept;
+
+    // count indices starting at firstIndex, baseVertex is added to every
+    // index before fetching the vertex
+    void Add(unsigned int count, unsigned int firstIndex, int baseVertex,
+             unsigned int baseInstance = 0, unsigned int instanceCount = 1);
+    void Clear();
+
+    // Sends the recorded commands to GL, does nothing without
+    // multi-draw indirect support since the fallback reads them on the CPU
+    void Upload();
+
+    void Bind() const;
+    void Unbind() const;
+
+    inline const std::vector<DrawElementsIndirectCommand>& GetCommands()
+        const {
+        return m_Commands;
+    }
+    inline unsigned int GetCount() const { return m_Commands.size(); }
+
+    // glMultiDrawElementsIndirect needs GL 4.3 or ARB_multi_draw_indirect
+    static bool IsSupported();
+};
@@ -0,0 +1,263 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Renderer.h"
+#include "glm/glm.hpp"
+
+// Cache of the last cacheSize distinct vertices, misses push out the oldest
+class FifoCache {
+   private:
+    // Time stamp of when the vertex entered the cache
+    std::vector<unsigned int> m_Time;
+    unsigned int m_Now;
+    unsigned int m_Size;
+
+   public:
+    FifoCache(unsigned int vertexCount, unsigned int size)
+        : m_Time(vertexCount, 0), m_Now(size + 1), m_Size(size) {}
+
+    // True if the vertex had to be transformed
+    bool Access(unsigned int vertex) {
+        if (m_Now - m_Time[vertex] <= m_Size) return false;
+        m_Time[vertex] = m_Now++;
+        return true;
+    }
+};
+
+VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices,
+                                    unsigned int vertexCount,
+                                    unsigned int cacheSize) {
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<bool> used(vertexCount, false);
+    unsigned int transformed = 0, unique = 0;
+
+    for (unsigned int index : indices) {
+        ASSERT(index < vertexCount);
+        transformed += cache.Access(index);
+        if (!used[index]) {
+            used[index] = true;
+            unique++;
+        }
+    }
+
+    unsigned int triangles = indices.size() / 3;
+    return {triangles ? (float)transformed / triangles : 0.0f,
+            unique ? (float)transformed / unique : 0.0f, transformed};
+}
+
+// For every vertex, the triangles using it, packed into one array
+struct Adjacency {
+    std::vector<unsigned int> Offsets;
+    std::vector<unsigned int> Counts;
+    std::vector<unsigned int> Triangles;
+
+    Adjacency(const std::vector<unsigned int>& indices,
+              unsigned int vertexCount)
+        : Offsets(vertexCount, 0),
+          Counts(vertexCount, 0),
+          Triangles(indices.size()) {
+        for (unsigned int index : indices) Counts[index]++;
+
+        unsigned int offset = 0;
+        for (unsigned int v = 0; v < vertexCount; ++v) {
+            Offsets[v] = offset;
+            offset += Counts[v];
+        }
+
+        std::vector<unsigned int> fill(Offsets);
+        for (unsigned int i = 0; i < indices.size(); ++i)
+            Triangles[fill[indices[i]]++] = i / 3;
+    }
+};
+
+void OptimizeVertexCache(std::vector<unsigned int>& indices,
+                         unsigned int vertexCount, unsigned int cacheSize) {
+    ASSERT(indices.size() % 3 == 0);
+    if (indices.empty()) return;
+
+    Adjacency adjacency(indices, vertexCount);
+    // Triangles still to emit per vertex
+    std::vector<unsigned int> live(adjacency.Counts);
+    std::vector<unsigned int> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(indices.size() / 3, false);
+    std::vector<unsigned int> deadEnd;
+    std::vector<unsigned int> candidates;
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+
+    unsigned int time = cacheSize + 1;
+    // Next vertex to look at when everything nearby is used up
+    unsigned int cursor = 0;
+    int fanning = 0;
+
+    while (fanning >= 0) {
+        // Emit every remaining triangle around the fanning vertex
+        candidates.clear();
+        unsigned int begin = adjacency.Offsets[fanning];
+        for (unsigned int i = 0; i < adjacency.Counts[fanning]; ++i) {
+            unsigned int triangle = adjacency.Triangles[begin + i];
+            if (emitted[triangle]) continue;
+            emitted[triangle] = true;
+
+            for (unsigned int k = 0; k < 3; ++k) {
+                unsigned int v = indices[triangle * 3 + k];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+            }
+        }
+
+        // Next fanning vertex, the candidate that will still be in the cache
+        // after its remaining triangles are emitted, oldest first
+        fanning = -1;
+        int best = -1;
+        for (unsigned int v : candidates) {
+            if (!live[v]) continue;
+            int priority = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+                priority = time - cacheTime[v];
+            if (priority > best) {
+                best = priority;
+                fanning = v;
+            }
+        }
+        if (fanning >= 0) continue;
+
+        // Dead end, go back to recently used vertices, then to any vertex
+        while (!deadEnd.empty()) {
+            unsigned int v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v]) {
+                fanning = v;
+                break;
+            }
+        }
+        while (fanning < 0 && cursor < vertexCount) {
+            if (live[cursor]) fanning = cursor;
+            cursor++;
+        }
+    }
+
+    ASSERT(result.size() == indices.size());
+    indices.swap(result);
+}
+
+void OptimizeOverdraw(std::vector<unsigned int>& indices,
+                      const float* positions, unsigned int positionStride,
+                      unsigned int vertexCount, float threshold,
+                      unsigned int cacheSize) {
+    ASSERT(indices.size() % 3 == 0);
+    unsigned int triangleCount = indices.size() / 3;
+    if (!triangleCount) return;
+
+    auto position = [&](unsigned int v) {
+        const float* p = reinterpret_cast<const float*>(
+            reinterpret_cast<const unsigned char*>(positions) +
+            v * positionStride);
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    // Cluster boundaries, at triangles where all three vertices miss the
+    // cache, so moving clusters around breaks no reuse between them
+    float meshACMR = AnalyzeVertexCache(indices, vertexCount, cacheSize).ACMR;
+    std::vector<unsigned int> clusters;
+    FifoCache cache(vertexCount, cacheSize);
+    unsigned int clusterMisses = 0;
+
+    for (unsigned int t = 0; t < triangleCount; ++t) {
+        unsigned int misses = 0;
+        for (unsigned int k = 0; k < 3; ++k)
+            misses += cache.Access(indices[t * 3 + k]);
+
+        unsigned int clusterStart = clusters.empty() ? 0 : clusters.back();
+        unsigned int clusterSize = t - clusterStart;
+        if (clusters.empty() ||
+            (misses == 3 && clusterSize &&
+             (float)clusterMisses / clusterSize <= meshACMR * threshold)) {
+            clusters.push_back(t);
+            clusterMisses = 0;
+        }
+        clusterMisses += misses;
+    }
+
+    // Area weighted centers and normals
+    glm::vec3 meshCenter(0.0f);
+    float meshArea = 0.0f;
+    std::vector<glm::vec3> centers(clusters.size(), glm::vec3(0.0f));
+    std::vector<glm::vec3> normals(clusters.size(), glm::vec3(0.0f));
+
+    for (unsigned int c = 0; c < clusters.size(); ++c) {
+        unsigned int end = c + 1 < clusters.size() ? clusters[c + 1]
+                                                   : triangleCount;
+        float clusterArea = 0.0f;
+        for (unsigned int t = clusters[c]; t < end; ++t) {
+            glm::vec3 a = position(indices[t * 3 + 0]);
+            glm::vec3 b = position(indices[t * 3 + 1]);
+            glm::vec3 d = position(indices[t * 3 + 2]);
+            glm::vec3 normal = glm::cross(b - a, d - a);
+            float area = glm::length(normal);
+
+            centers[c] += (a + b + d) * (area / 3.0f);
+            normals[c] += normal;
+            clusterArea += area;
+        }
+        meshCenter += centers[c];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0f) centers[c] /= clusterArea;
+    }
+    if (meshArea > 0.0f) meshCenter /= meshArea;
+
+    // Clusters facing away from the center are on the outside, draw them
+    // first
+    std::vector<float> order(clusters.size());
+    std::vector<unsigned int> sorted(clusters.size());
+    for (unsigned int c = 0; c < clusters.size(); ++c) {
+        order[c] = glm::dot(centers[c] - meshCenter, normals[c]);
+        sorted[c] = c;
+    }
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [&](unsigned int a, unsigned int b) {
+                         return order[a] > order[b];
+                     });
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (unsigned int c : sorted) {
+        unsigned int end = c + 1 < clusters.size() ? clusters[c + 1]
+                                                   : triangleCount;
+        result.insert(result.end(), indices.begin() + clusters[c] * 3,
+                      indices.begin() + end * 3);
+    }
+    indices.swap(result);
+}
+
+unsigned int OptimizeVertexFetch(std::vector<unsigned int>& indices,
+                                 void* vertices, unsigned int vertexCount,
+                                 unsigned int vertexSize) {
+    const unsigned int Unused = ~0u;
+    std::vector<unsigned int> remap(vertexCount, Unused);
+    unsigned int next = 0;
+
+    for (unsigned int& index : indices) {
+        if (remap[index] == Unused) remap[index] = next++;
+        index = remap[index];
+    }
+
+    // Unreferenced vertices keep their relative order after the used ones
+    unsigned int used = next;
+    for (unsigned int& slot : remap)
+        if (slot == Unused) slot = next++;
+
+    unsigned char* data = static_cast<unsigned char*>(vertices);
+    std::vector<unsigned char> copy(data, data + vertexCount * vertexSize);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        memcpy(data + remap[v] * vertexSize, copy.data() + v * vertexSize,
+               vertexSize);
+
+    return used;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+
+// Offline passes over triangle lists, run once when a mesh is loaded and
+// before it goes into an IndexBuffer. The usual order is
+//   OptimizeVertexCache -> OptimizeOverdraw -> OptimizeVertexFetch
+// since each pass keeps what the previous one did as far as it can.
+
+struct VertexCacheStats {
+    // Vertex shader runs per triangle, 3 with no reuse at all, ~0.5 at best
+    // for large regular meshes
+    float ACMR;
+    // Vertex shader runs per vertex of the mesh, 1 is ideal
+    float ATVR;
+    unsigned int Transformed;
+};
+
+// Simulates a FIFO post-transform cache of cacheSize vertices
+VertexCacheStats AnalyzeVertexCache(const std::vector<unsigned int>& indices,
+                                    unsigned int vertexCount,
+                                    unsigned int cacheSize = 16);
+
+// Reorders triangles so vertices are reused while still in the
+// post-transform cache (Tipsify, Sander et al. 2007). Linear time, which
+// matters for large meshes, and close to the slower Forsyth ordering.
+void OptimizeVertexCache(std::vector<unsigned int>& indices,
+                         unsigned int vertexCount, unsigned int cacheSize = 16);
+
+// Splits cache-ordered triangles into clusters and draws outward facing
+// clusters first, so they hide what is behind them before it gets shaded.
+// Clusters only start where the cache restarts anyway and the ACMR of the
+// cluster is within threshold of the whole mesh, which bounds what this
+// costs in vertex cache efficiency. positions points at x, y, z floats
+// repeated every positionStride bytes.
+void OptimizeOverdraw(std::vector<unsigned int>& indices,
+                      const float* positions, unsigned int positionStride,
+                      unsigned int vertexCount, float threshold = 1.05f,
+                      unsigned int cacheSize = 16);
+
+// Renumbers vertices in the order the indices first use them and moves the
+// vertex data to match, so fetches walk through memory instead of jumping.
+// Vertices nothing references end up past the returned count.
+unsigned int OptimizeVertexFetch(std::vector<unsigned int>& indices,
+                                 void* vertices, unsigned int vertexCount,
+                                 unsigned int vertexSize);
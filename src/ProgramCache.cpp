@@ -0,0 +1,182 @@
+#include "ProgramCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "Hash.h"
+#include "Renderer.h"
+
+namespace fs = std::filesystem;
+
+// Written in front of every binary, a file from an older layout or a
+// truncated write is treated as missing
+struct ProgramBinaryHeader {
+    uint32_t Magic;
+    uint32_t Format;
+    uint32_t Size;
+};
+
+static const uint32_t s_Magic = 0x31425047;  // "GPB1"
+
+// Separator after each part so "ab" + "c" and "a" + "bc" differ
+static uint64_t Hash(uint64_t hash, const std::string& data) {
+    return HashFNV1a("", 1, HashFNV1a(data, hash));
+}
+
+static std::string GetString(GLenum name) {
+    GLCall(const GLubyte* value = glGetString(name));
+    return value ? (const char*)value : "";
+}
+
+ProgramCache::ProgramCache() : m_Directory(".shader_cache"), m_Enabled(true) {}
+
+ProgramCache& ProgramCache::Get() {
+    static ProgramCache s_Cache;
+    return s_Cache;
+}
+
+bool ProgramCache::IsSupported() {
+    if (!GLEW_ARB_get_program_binary) return false;
+    int formats = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats));
+    return formats > 0;
+}
+
+void ProgramCache::SetDirectory(const std::string& directory) {
+    m_Directory = directory;
+}
+
+void ProgramCache::SetEnabled(bool enabled) { m_Enabled = enabled; }
+
+uint64_t ProgramCache::GetKey(const std::string& vertexSource,
+                              const std::string& fragmentSource) {
+    uint64_t hash = Hash(FNVOffsetBasis, GetString(GL_VENDOR));
+    hash = Hash(hash, GetString(GL_RENDERER));
+    hash = Hash(hash, GetString(GL_VERSION));
+    hash = Hash(hash, vertexSource);
+    return Hash(hash, fragmentSource);
+}
+
+unsigned int ProgramCache::Load(uint64_t key) {
+    if (!m_Enabled || !IsSupported()) return 0;
+
+    std::string path = GetPath(key);
+    std::ifstream file(path, std::ios::binary);
+    ProgramBinaryHeader header;
+    if (!file.read((char*)&header, sizeof(header)) ||
+        header.Magic != s_Magic) {
+        m_Stats.Misses++;
+        return 0;
+    }
+    // The size comes from the file itself, a corrupt one could ask for
+    // gigabytes; it has to be exactly what follows the header
+    std::error_code error;
+    uintmax_t fileSize = fs::file_size(path, error);
+    if (error || fileSize != sizeof(header) + (uintmax_t)header.Size) {
+        m_Stats.Misses++;
+        return 0;
+    }
+    std::vector<char> binary(header.Size);
+    if (!file.read(binary.data(), binary.size())) {
+        m_Stats.Misses++;
+        return 0;
+    }
+    file.close();
+
+    // glProgramBinary raises an error for a format the driver doesn't list,
+    // only hand it ones it does
+    int formatCount = 0;
+    GLCall(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount));
+    std::vector<int> formats(formatCount);
+    GLCall(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats.data()));
+    bool known = std::find(formats.begin(), formats.end(),
+                           (int)header.Format) != formats.end();
+
+    int linked = GL_FALSE;
+    unsigned int program = 0;
+    if (known) {
+        GLCall(program = glCreateProgram());
+        GLCall(glProgramBinary(program, header.Format, binary.data(),
+                               binary.size()));
+        GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    }
+
+    if (linked == GL_FALSE) {
+        // Stale, the caller compiles from source and stores a new one
+        if (program) {
+            GLCall(glDeleteProgram(program));
+        }
+        std::remove(path.c_str());
+        m_Stats.Rejected++;
+        return 0;
+    }
+
+    m_Stats.Hits++;
+    return program;
+}
+
+void ProgramCache::PrepareForStore(unsigned int program) {
+    if (!m_Enabled || !IsSupported()) return;
+    GLCall(glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                               GL_TRUE));
+}
+
+void ProgramCache::Store(uint64_t key, unsigned int program) {
+    if (!m_Enabled || !IsSupported()) return;
+
+    int length = 0;
+    GLCall(glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length));
+    if (length <= 0) return;
+
+    std::vector<char> binary(length);
+    GLenum format;
+    GLCall(glGetProgramBinary(program, length, &length, &format,
+                              binary.data()));
+
+    std::error_code error;
+    fs::create_directories(m_Directory, error);
+
+    // Written next to the final name and renamed, another instance starting
+    // at the same time never reads half a file. The random suffix keeps two
+    // instances storing the same program from writing into one temporary
+    std::string path = GetPath(key);
+    std::string temporary =
+        path + "." + std::to_string(std::random_device()()) + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    ProgramBinaryHeader header = {s_Magic, format, (uint32_t)length};
+    file.write((const char*)&header, sizeof(header));
+    file.write(binary.data(), length);
+    // Closed before checking, the last bytes may only fail on the flush
+    file.close();
+    if (!file) {
+        std::cout << "Failed to write program binary " << temporary << '\n';
+        fs::remove(temporary, error);
+        return;
+    }
+
+    fs::rename(temporary, path, error);
+    if (error) {
+        std::cout << "Failed to store program binary " << path << ": "
+                  << error.message() << '\n';
+        fs::remove(temporary, error);
+        return;
+    }
+    m_Stats.Stored++;
+}
+
+void ProgramCache::Clear() {
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(m_Directory, error))
+        fs::remove(entry.path(), error);
+}
+
+std::string ProgramCache::GetPath(uint64_t key) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+    return m_Directory + "/" + name;
+}
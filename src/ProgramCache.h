@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Linked programs saved to disk with glGetProgramBinary and loaded back with
+// glProgramBinary, which skips compiling and linking on the next launch.
+// Binaries only work on the driver that made them, so the key hashes the
+// vendor, renderer and version strings along with the sources. A driver
+// update changes the key, and a binary the driver rejects anyway is deleted
+// so the caller compiles from source and stores a fresh one.
+class ProgramCache {
+   public:
+    struct Stats {
+        unsigned int Hits = 0;
+        unsigned int Misses = 0;
+        // Found on disk but refused by the driver
+        unsigned int Rejected = 0;
+        unsigned int Stored = 0;
+    };
+
+   private:
+    std::string m_Directory;
+    bool m_Enabled;
+    Stats m_Stats;
+
+   public:
+    ProgramCache();
+
+    static ProgramCache& Get();
+
+    // Needs a current context, false when the driver has no binary formats
+    static bool IsSupported();
+
+    // Where binaries are written, relative to the working directory like
+    // res/ is. Created on the first store.
+    void SetDirectory(const std::string& directory);
+    // Disabled, Load always misses and Store does nothing
+    void SetEnabled(bool enabled);
+
+    // Identifies a program built from these sources on the current driver
+    static uint64_t GetKey(const std::string& vertexSource,
+                           const std::string& fragmentSource);
+
+    // A linked program from the binary stored under key, 0 if there is none
+    // or the driver doesn't accept it
+    unsigned int Load(uint64_t key);
+    // Call before linking a program that is going to be stored, drivers may
+    // not keep what glGetProgramBinary needs otherwise
+    void PrepareForStore(unsigned int program);
+    // Saves the binary of a successfully linked program under key
+    void Store(uint64_t key, unsigned int program);
+    // Deletes every stored binary
+    void Clear();
+
+    inline const std::string& GetDirectory() const { return m_Directory; }
+    inline bool IsEnabled() const { return m_Enabled; }
+    inline const Stats& GetStats() const { return m_Stats; }
+
+   private:
+    std::string GetPath(uint64_t key) const;
+};
@@ -0,0 +1,86 @@
+#include "RangeAllocator.h"
+
+#include <iterator>
+
+#include "Renderer.h"
+
+RangeAllocator::RangeAllocator(unsigned int capacity)
+    : m_Capacity(0), m_Used(0), m_Allocations(0) {
+    Grow(capacity);
+}
+
+unsigned int RangeAllocator::Allocate(unsigned int size) {
+    if (!size) return Invalid;
+
+    // Best fit keeps large blocks around for large allocations
+    auto best = m_FreeBlocks.end();
+    for (auto it = m_FreeBlocks.begin(); it != m_FreeBlocks.end(); ++it) {
+        if (it->second < size) continue;
+        if (best == m_FreeBlocks.end() || it->second < best->second)
+            best = it;
+        if (best->second == size) break;
+    }
+    if (best == m_FreeBlocks.end()) return Invalid;
+
+    unsigned int offset = best->first;
+    unsigned int remaining = best->second - size;
+    m_FreeBlocks.erase(best);
+    if (remaining) m_FreeBlocks[offset + size] = remaining;
+
+    m_Used += size;
+    m_Allocations++;
+    return offset;
+}
+
+void RangeAllocator::Free(unsigned int offset, unsigned int size) {
+    if (!size) return;
+    ASSERT(offset + size <= m_Capacity);
+
+    m_Used -= size;
+    m_Allocations--;
+
+    auto next = m_FreeBlocks.lower_bound(offset);
+    ASSERT(next == m_FreeBlocks.end() || offset + size <= next->first);
+
+    // Merge with the block right after
+    if (next != m_FreeBlocks.end() && offset + size == next->first) {
+        size += next->second;
+        next = m_FreeBlocks.erase(next);
+    }
+
+    // And with the block right before
+    if (next != m_FreeBlocks.begin()) {
+        auto previous = std::prev(next);
+        ASSERT(previous->first + previous->second <= offset);
+        if (previous->first + previous->second == offset) {
+            previous->second += size;
+            return;
+        }
+    }
+    m_FreeBlocks.emplace_hint(next, offset, size);
+}
+
+void RangeAllocator::Grow(unsigned int newCapacity) {
+    if (newCapacity <= m_Capacity) return;
+
+    unsigned int added = newCapacity - m_Capacity;
+    unsigned int offset = m_Capacity;
+    m_Capacity = newCapacity;
+
+    // Grow is free space appearing at the end, same as freeing it
+    m_Used += added;
+    m_Allocations++;
+    Free(offset, added);
+}
+
+RangeAllocator::Stats RangeAllocator::GetStats() const {
+    Stats stats;
+    stats.Capacity = m_Capacity;
+    stats.Used = m_Used;
+    stats.Allocations = m_Allocations;
+    stats.FreeBlocks = m_FreeBlocks.size();
+    for (const auto& block : m_FreeBlocks)
+        if (block.second > stats.LargestFreeBlock)
+            stats.LargestFreeBlock = block.second;
+    return stats;
+}
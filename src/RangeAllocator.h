@@ -0,0 +1,47 @@
+#pragma once
+
+#include <map>
+
+// Hands out ranges of [0, capacity) in abstract units (bytes, vertices,
+// indices). Free ranges are kept in an ordered list, allocation takes the
+// smallest one that fits and freeing merges with the free neighbours, so
+// a range that is freed entirely becomes one block again.
+class RangeAllocator {
+   public:
+    static const unsigned int Invalid = ~0u;
+
+    struct Stats {
+        unsigned int Capacity = 0;
+        unsigned int Used = 0;
+        unsigned int Allocations = 0;
+        unsigned int FreeBlocks = 0;
+        unsigned int LargestFreeBlock = 0;
+
+        // 0 when all free space is one block, close to 1 when it is split
+        // into many small holes none of which fits a large allocation
+        inline float GetFragmentation() const {
+            unsigned int free = Capacity - Used;
+            return free ? 1.0f - (float)LargestFreeBlock / free : 0.0f;
+        }
+    };
+
+   private:
+    // Offset to size of every free block
+    std::map<unsigned int, unsigned int> m_FreeBlocks;
+    unsigned int m_Capacity;
+    unsigned int m_Used;
+    unsigned int m_Allocations;
+
+   public:
+    RangeAllocator(unsigned int capacity);
+
+    // Offset of size free units, Invalid if no free block is large enough
+    unsigned int Allocate(unsigned int size);
+    void Free(unsigned int offset, unsigned int size);
+
+    // Adds [capacity, newCapacity) as free space
+    void Grow(unsigned int newCapacity);
+
+    inline unsigned int GetCapacity() const { return m_Capacity; }
+    Stats GetStats() const;
+};
@@ -0,0 +1,109 @@
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+#include "Renderer.h"
+#include "Texture.h"
+
+uint64_t RenderQueue::MakeKey(unsigned int pass, unsigned int shader,
+                              unsigned int texture, unsigned int va,
+                              float depth) {
+    // GL names are small integers in practice, only the low bits are kept
+    uint64_t depthBits =
+        (uint64_t)(std::min(std::max(depth, 0.0f), 1.0f) * 0xffffff);
+    return ((uint64_t)(pass & 0xf) << 60) |
+           ((uint64_t)(shader & 0xfff) << 48) |
+           ((uint64_t)(texture & 0xfff) << 36) |
+           ((uint64_t)(va & 0xfff) << 24) | depthBits;
+}
+
+void RenderQueue::Submit(const VertexArray& va, const IndexBuffer& ib,
+                         const Shader& shader, const Texture* texture,
+                         float depth, unsigned int pass) {
+    ASSERT(pass <= MaxPass);
+    uint64_t key = MakeKey(pass, shader.GetRendererID(),
+                           texture ? texture->GetRendererID() : 0,
+                           va.GetRendererID(), depth);
+    m_Commands.push_back({key, &va, &ib, &shader, texture});
+}
+
+// LSD radix sort on the 64-bit key, one byte per pass. Passes where every
+// key has the same byte are skipped, which is most of them for a typical
+// frame since pass and name bits vary little.
+void RenderQueue::Sort() {
+    unsigned int count = m_Commands.size();
+    m_Scratch.resize(count);
+
+    for (unsigned int shift = 0; shift < 64; shift += 8) {
+        unsigned int histogram[256] = {};
+        for (const RenderCommand& command : m_Commands)
+            histogram[(command.key >> shift) & 0xff]++;
+
+        if (histogram[(m_Commands[0].key >> shift) & 0xff] == count) continue;
+
+        unsigned int offsets[256];
+        unsigned int sum = 0;
+        for (unsigned int i = 0; i < 256; ++i) {
+            offsets[i] = sum;
+            sum += histogram[i];
+        }
+
+        // Stable scatter keeps the order of earlier (less significant) passes
+        for (const RenderCommand& command : m_Commands)
+            m_Scratch[offsets[(command.key >> shift) & 0xff]++] = command;
+        m_Commands.swap(m_Scratch);
+    }
+}
+
+unsigned int RenderQueue::CountStateChanges(
+    const std::vector<RenderCommand>& commands) {
+    unsigned int changes = 0;
+    const Shader* shader = nullptr;
+    const Texture* texture = nullptr;
+    const VertexArray* va = nullptr;
+    for (const RenderCommand& command : commands) {
+        if (command.shader != shader) changes++;
+        if (command.texture && command.texture != texture) changes++;
+        if (command.va != va) changes++;
+        shader = command.shader;
+        if (command.texture) texture = command.texture;
+        va = command.va;
+    }
+    return changes;
+}
+
+void RenderQueue::Flush() {
+    m_Stats = RenderQueueStats();
+    m_Stats.Commands = m_Commands.size();
+    if (m_Commands.empty()) return;
+
+    m_Stats.StateChangesUnsorted = CountStateChanges(m_Commands);
+    Sort();
+
+    const Shader* shader = nullptr;
+    const Texture* texture = nullptr;
+    const VertexArray* va = nullptr;
+    for (const RenderCommand& command : m_Commands) {
+        if (command.shader != shader) {
+            command.shader->Bind();
+            shader = command.shader;
+            m_Stats.StateChangesSorted++;
+        }
+        if (command.texture && command.texture != texture) {
+            command.texture->Bind();
+            texture = command.texture;
+            m_Stats.StateChangesSorted++;
+        }
+        if (command.va != va) {
+            command.va->Bind();
+            va = command.va;
+            m_Stats.StateChangesSorted++;
+        }
+        // Skipped by GLState when the vertex array already has it
+        command.ib->Bind();
+        GLCall(glDrawElements(GL_TRIANGLES, command.ib->GetCount(),
+                              command.ib->GetType(), nullptr));
+    }
+
+    m_Commands.clear();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "IndexBuffer.h"
+#include "Shader.h"
+#include "VertexArray.h"
+
+class Texture;
+
+// One recorded draw. The key decides execution order, the pointers are what
+// actually gets bound, so a collision in the key only costs a state change.
+//
+// Key layout, most significant bits first:
+//   pass (4) | shader (12) | texture (12) | vertex array (12) | depth (24)
+struct RenderCommand {
+    uint64_t key;
+    const VertexArray* va;
+    const IndexBuffer* ib;
+    const Shader* shader;
+    const Texture* texture;
+};
+
+struct RenderQueueStats {
+    unsigned int Commands = 0;
+    // Shader, texture and vertex array binds in submission order
+    unsigned int StateChangesUnsorted = 0;
+    // Same, after sorting, this is what was actually issued
+    unsigned int StateChangesSorted = 0;
+
+    // Negative if sorting made things worse, no wrapping around
+    inline int Saved() const {
+        return (int)StateChangesUnsorted - (int)StateChangesSorted;
+    }
+};
+
+class RenderQueue {
+   private:
+    std::vector<RenderCommand> m_Commands;
+    // Scratch space for the radix sort, kept to avoid reallocating per frame
+    std::vector<RenderCommand> m_Scratch;
+    RenderQueueStats m_Stats;
+
+   public:
+    static const unsigned int MaxPass = 15;
+
+    // Depth is expected in [0, 1], lower values are drawn first. Passes with
+    // transparency should submit 1 - depth to get back to front order.
+    void Submit(const VertexArray& va, const IndexBuffer& ib,
+                const Shader& shader, const Texture* texture, float depth,
+                unsigned int pass);
+
+    // Sorts the recorded commands, draws them and clears the queue
+    void Flush();
+
+    inline const RenderQueueStats& GetStats() const { return m_Stats; }
+
+    static uint64_t MakeKey(unsigned int pass, unsigned int shader,
+                            unsigned int texture, unsigned int va,
+                            float depth);
+
+   private:
+    void Sort();
+    static unsigned int CountStateChanges(
+        const std::vector<RenderCommand>& commands);
+};
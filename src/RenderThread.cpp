@@ -0,0 +1,88 @@
+#include "RenderThread.h"
+
+#include <GLFW/glfw3.h>
+
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "Renderer.h"
+
+RenderThread::RenderThread(GLFWwindow* window, unsigned int listCount)
+    : m_Window(window),
+      m_Lists(listCount),
+      m_Recording(0),
+      m_Stopping(false) {
+    ASSERT(listCount >= 2);
+    for (unsigned int i = 0; i < listCount; ++i) m_Free.push_back(i);
+}
+
+RenderThread::~RenderThread() { Stop(); }
+
+void RenderThread::Start() {
+    // A context can only be current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    m_Stopping = false;
+    m_Thread = std::thread(&RenderThread::Run, this);
+}
+
+void RenderThread::Stop() {
+    if (!m_Thread.joinable()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    m_Thread.join();
+
+    glfwMakeContextCurrent(m_Window);
+    // The render thread changed the bindings behind this thread's back
+    GLState::Get().Invalidate();
+}
+
+CommandList& RenderThread::BeginFrame() {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return !m_Free.empty(); });
+    m_Recording = m_Free.front();
+    m_Free.pop_front();
+    return m_Lists[m_Recording];
+}
+
+void RenderThread::EndFrame() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Submitted.push_back(m_Recording);
+    }
+    m_Condition.notify_all();
+}
+
+void RenderThread::Run() {
+    glfwMakeContextCurrent(m_Window);
+
+    while (true) {
+        unsigned int index;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(
+                lock, [this] { return !m_Submitted.empty() || m_Stopping; });
+            // Stop only once everything submitted has been drawn
+            if (m_Submitted.empty()) break;
+            index = m_Submitted.front();
+            m_Submitted.pop_front();
+        }
+
+        m_Lists[index].Execute();
+        m_Lists[index].Clear();
+        GLCheckpoint("end of frame");
+
+        glfwSwapBuffers(m_Window);
+        DeletionQueue::Get().Collect();
+
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Free.push_back(index);
+        }
+        m_Condition.notify_all();
+    }
+
+    glfwMakeContextCurrent(nullptr);
+}
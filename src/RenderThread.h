@@ -0,0 +1,51 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "CommandList.h"
+
+struct GLFWwindow;
+
+// Owns the window's GL context on a thread of its own. The main thread
+// records a CommandList per frame and hands it over, the render thread
+// executes it and swaps buffers. While frame N is being submitted (or
+// waiting for vsync) the main thread is already updating frame N + 1.
+class RenderThread {
+   private:
+    GLFWwindow* m_Window;
+    std::thread m_Thread;
+
+    // Lists cycle between free, recording (main thread) and submitted
+    std::vector<CommandList> m_Lists;
+    std::deque<unsigned int> m_Free;
+    std::deque<unsigned int> m_Submitted;
+    unsigned int m_Recording;
+
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    bool m_Stopping;
+
+   public:
+    // listCount is how many frames can be in flight, 2 is double buffering
+    RenderThread(GLFWwindow* window, unsigned int listCount = 2);
+    ~RenderThread();
+
+    // Takes the context away from the calling thread, create GL resources
+    // before this and destroy them after Stop
+    void Start();
+    // Executes everything already submitted, then gives the context back
+    // to the calling thread
+    void Stop();
+
+    // Blocks until a list is free, this is where the main thread waits when
+    // it gets too far ahead of the GPU
+    CommandList& BeginFrame();
+    void EndFrame();
+
+   private:
+    void Run();
+};
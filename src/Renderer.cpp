@@ -16,15 +16,137 @@ bool GLLogCall(const char* function, const char* file, int line) {
     return true;
 }
 
+bool GLLogErrors(const char* label, const char* file, int line) {
+    bool ok = true;
+    while (GLenum error = glGetError()) {
+        std::cout << "[OpenGL Error] (0x" << std::hex << error << std::dec
+                  << "): before checkpoint " << label << " " << file << ":"
+                  << line << '\n';
+        ok = false;
+    }
+    return ok;
+}
+
+static void GLAPIENTRY GLDebugMessageCallback(GLenum, GLenum type, GLuint id,
+                                              GLenum severity, GLsizei,
+                                              const GLchar* message,
+                                              const void*) {
+    // Notifications are mostly buffer placement chatter
+    if (severity == GL_DEBUG_SEVERITY_NOTIFICATION) return;
+
+    std::cout << "[OpenGL Debug] (0x" << std::hex << id << std::dec << ") "
+              << (type == GL_DEBUG_TYPE_ERROR ? "error" : "message") << ": "
+              << message << '\n';
+}
+
+void GLEnableDebugOutput() {
+    if (!GLEW_KHR_debug) {
+        std::cout << "KHR_debug not supported, GL errors will not be reported "
+                     "in this build\n";
+        return;
+    }
+
+    GLCall(glEnable(GL_DEBUG_OUTPUT));
+#if GL_CHECK_MODE == GL_CHECK_CALLS
+    // Report the message on the offending call so a breakpoint in the
+    // callback shows where it came from
+    GLCall(glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+#else
+    // Asynchronous output doesn't serialize the driver
+    GLCall(glDisable(GL_DEBUG_OUTPUT_SYNCHRONOUS));
+#endif
+    GLCall(glDebugMessageCallback(GLDebugMessageCallback, nullptr));
+}
+
 void Renderer::Clear() const { GLCall(glClear(GL_COLOR_BUFFER_BIT)); }
 
 void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib,
                     const Shader& shader) const {
+    Draw(va, ib, shader, ib.GetCount());
+}
+
+void Renderer::Draw(const VertexArray& va, const IndexBuffer& ib,
+                    const Shader& shader, unsigned int count,
+                    unsigned int firstIndex, int baseVertex) const {
+    ASSERT(firstIndex + count <= ib.GetCount());
     shader.Bind();
     va.Bind();
+    // Part of the vertex array state, GLState skips this when the vertex
+    // array already has it (see VertexArray::SetIndexBuffer)
+    ib.Bind();
 
     // Draw six vertices forming two triangles
     // glDrawArrays(GL_TRIANGLES, 0, 6); - if drawing without index buffers
-    GLCall(
-        glDrawElements(GL_TRIANGLES, ib.GetCount(), GL_UNSIGNED_INT, nullptr));
-}
\ No newline at end of file
+    const void* offset =
+        reinterpret_cast<const void*>(firstIndex * ib.GetIndexSize());
+    if (baseVertex) {
+        GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, count, ib.GetType(),
+                                        offset, baseVertex));
+    } else {
+        GLCall(glDrawElements(GL_TRIANGLES, count, ib.GetType(), offset));
+    }
+}
+
+void Renderer::DrawInstanced(const VertexArray& va, const IndexBuffer& ib,
+                             const Shader& shader,
+                             unsigned int instanceCount) const {
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+
+    GLCall(glDrawElementsInstanced(GL_TRIANGLES, ib.GetCount(),
+                                   ib.GetType(), nullptr, instanceCount));
+}
+
+void Renderer::MultiDrawIndirect(const VertexArray& va, const IndexBuffer& ib,
+                                 const Shader& shader,
+                                 const IndirectBuffer& commands) const {
+    if (!commands.GetCount()) return;
+
+    shader.Bind();
+    va.Bind();
+    ib.Bind();
+
+    if (IndirectBuffer::IsSupported()) {
+        commands.Bind();
+        GLCall(glMultiDrawElementsIndirect(GL_TRIANGLES, ib.GetType(),
+                                           nullptr, commands.GetCount(), 0));
+        return;
+    }
+
+    for (const DrawElementsIndirectCommand& command : commands.GetCommands()) {
+        ASSERT(command.firstIndex + command.count <= ib.GetCount());
+        // Per-instance attributes would silently start at instance 0
+        static bool warned = false;
+        if (command.baseInstance && !GLEW_ARB_base_instance && !warned) {
+            std::cout << "Warning: no ARB_base_instance, indirect draws with "
+                         "a base instance read instance data from 0\n";
+            warned = true;
+        }
+        const void* offset = reinterpret_cast<const void*>(
+            command.firstIndex * ib.GetIndexSize());
+
+        if (command.baseInstance && GLEW_ARB_base_instance) {
+            GLCall(glDrawElementsInstancedBaseVertexBaseInstance(
+                GL_TRIANGLES, command.count, ib.GetType(), offset,
+                command.instanceCount, command.baseVertex,
+                command.baseInstance));
+        } else if (command.instanceCount != 1) {
+            GLCall(glDrawElementsInstancedBaseVertex(
+                GL_TRIANGLES, command.count, ib.GetType(), offset,
+                command.instanceCount, command.baseVertex));
+        } else {
+            GLCall(glDrawElementsBaseVertex(GL_TRIANGLES, command.count,
+                                            ib.GetType(), offset,
+                                            command.baseVertex));
+        }
+    }
+}
+
+void Renderer::Submit(const VertexArray& va, const IndexBuffer& ib,
+                      const Shader& shader, const Texture* texture,
+                      float depth, unsigned int pass) {
+    m_Queue.Submit(va, ib, shader, texture, depth, pass);
+}
+
+void Renderer::Flush() { m_Queue.Flush(); }
\ No newline at end of file
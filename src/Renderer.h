@@ -5,22 +5,91 @@
 #include <signal.h>
 
 #include "IndexBuffer.h"
+#include "IndirectBuffer.h"
+#include "RenderQueue.h"
 #include "Shader.h"
 #include "VertexArray.h"
 
+// How GL errors are caught, pick one with -DGL_CHECK_MODE=<mode>
+//   GL_CHECK_CALLS       glGetError before and after every GLCall (default)
+//   GL_CHECK_CHECKPOINT  GLCall is the bare call, GLCheckpoint drains the
+//                        error queue once, e.g. at the end of every frame
+//   GL_CHECK_NONE        GLCall is the bare call, errors are only reported by
+//                        the asynchronous KHR_debug callback
+// glGetError can stall the pipeline on many drivers, so the latter two are
+// what you want when measuring anything.
+#define GL_CHECK_NONE 0
+#define GL_CHECK_CHECKPOINT 1
+#define GL_CHECK_CALLS 2
+
+#ifndef GL_CHECK_MODE
+#define GL_CHECK_MODE GL_CHECK_CALLS
+#endif
+
 #define ASSERT(x) \
     if (!(x)) raise(SIGTRAP)
+
+#if GL_CHECK_MODE == GL_CHECK_CALLS
 #define GLCall(x)   \
     GLClearError(); \
     x;              \
     ASSERT(GLLogCall(#x, __FILE__, __LINE__))
+#else
+#define GLCall(x) x
+#endif
+
+#if GL_CHECK_MODE == GL_CHECK_CHECKPOINT
+#define GLCheckpoint(label) ASSERT(GLLogErrors(label, __FILE__, __LINE__))
+#else
+#define GLCheckpoint(label)
+#endif
 
 void GLClearError();
 bool GLLogCall(const char* function, const char* file, int line);
+// Reports every pending error, not just the first one
+bool GLLogErrors(const char* label, const char* file, int line);
+// Installs the KHR_debug message callback if the context supports it.
+// Call once after glewInit.
+void GLEnableDebugOutput();
+
+// GL 4.5 or ARB_direct_state_access, objects can be created and edited by
+// name without binding them first
+inline bool GLHasDirectStateAccess() { return GLEW_ARB_direct_state_access; }
 
 class Renderer {
+   private:
+    RenderQueue m_Queue;
+
    public:
     void Clear() const;
     void Draw(const VertexArray& va, const IndexBuffer& ib,
               const Shader& shader) const;
+    // Draws count indices starting at firstIndex, baseVertex is added to
+    // every index (meshes sharing a buffer, vertices streamed at an offset)
+    void Draw(const VertexArray& va, const IndexBuffer& ib,
+              const Shader& shader, unsigned int count,
+              unsigned int firstIndex = 0, int baseVertex = 0) const;
+    // Draws instanceCount copies of the mesh, attributes with a divisor
+    // advance per instance instead of per vertex
+    void DrawInstanced(const VertexArray& va, const IndexBuffer& ib,
+                       const Shader& shader, unsigned int instanceCount) const;
+    // Draws every command of the indirect buffer with a single
+    // glMultiDrawElementsIndirect, the commands index into ib and read
+    // vertices through va. Without multi-draw indirect support this falls
+    // back to one glDrawElementsBaseVertex per command.
+    void MultiDrawIndirect(const VertexArray& va, const IndexBuffer& ib,
+                           const Shader& shader,
+                           const IndirectBuffer& commands) const;
+
+    // Records a draw instead of issuing it, Flush sorts the recorded draws
+    // so that shader, texture and vertex array changes are grouped
+    void Submit(const VertexArray& va, const IndexBuffer& ib,
+                const Shader& shader, const Texture* texture = nullptr,
+                float depth = 0.0f, unsigned int pass = 0);
+    void Flush();
+
+    // Counts for the last Flush
+    inline const RenderQueueStats& GetQueueStats() const {
+        return m_Queue.GetStats();
+    }
 };
\ No newline at end of file
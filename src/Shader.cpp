@@ -1,34 +1,73 @@
 #include "Shader.h"
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <utility>
 
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "ProgramCache.h"
 #include "Renderer.h"
+#include "UniformBuffer.h"
 // Vertex shader is run for every vertex once
 // It tells where on screen vertex should be positioned
 
 // Fragment shader is run for every pixel, it tells its colour
 
-Shader::Shader(const std::string &filepath)
-    : m_FilePath(filepath), m_RendererID(0) {
-    ShaderProgramSource source = ParseShader(filepath);
+Shader::Shader(const std::string &filepath, const ShaderDefines &defines)
+    : m_FilePath(filepath), m_Defines(defines), m_RendererID(0) {
+    ShaderProgramSource source = ParseShader(filepath, defines);
+    m_SourceFiles = std::move(source.Files);
 
     // Shaders are combined (linked) in one program which will run on GPU
     m_RendererID = CreateShader(source.VertexSource, source.FragmentSource);
+    Reflect();
+}
+Shader::~Shader() {
+    DeletionQueue::Get().Push(GLObjectType::Program, m_RendererID);
 }
-Shader::~Shader() { GLCall(glDeleteProgram(m_RendererID)); }
 
-ShaderProgramSource Shader::ParseShader(const std::string &filepath) {
-    // Open file which is divided to shaders by #shader statemenets
-    std::ifstream stream(filepath);
+Shader::Shader(Shader &&other) noexcept
+    : m_FilePath(std::move(other.m_FilePath)),
+      m_Defines(std::move(other.m_Defines)),
+      m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_Uniforms(std::move(other.m_Uniforms)),
+      m_SourceFiles(std::move(other.m_SourceFiles)) {}
+
+// Our old program goes to other and is deleted along with it
+Shader &Shader::operator=(Shader &&other) noexcept {
+    std::swap(m_FilePath, other.m_FilePath);
+    std::swap(m_Defines, other.m_Defines);
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_Uniforms, other.m_Uniforms);
+    std::swap(m_SourceFiles, other.m_SourceFiles);
+    return *this;
+}
+
+ShaderProgramSource Shader::ParseShader(const std::string &filepath,
+                                        const ShaderDefines &defines) {
+    // Includes are resolved first, so they may contain whole stages too
+    std::string expanded;
+    std::vector<std::string> includeStack, files;
+    ExpandIncludes(filepath, expanded, includeStack, files);
+
+    // File which is divided to shaders by #shader statemenets
+    std::istringstream stream(expanded);
 
     enum class ShaderType { NONE = -1, VERTEX = 0, FRAGMENT = 1 };
 
+    std::string defineLines;
+    for (const auto &define : defines)
+        defineLines += "#define " + define.first + " " + define.second + "\n";
+
     std::string line;
     std::stringstream ss[2];
     ShaderType type = ShaderType::NONE;
+    // #version has to come first, defines go right after it
+    bool defined[2] = {false, false};
 
     while (getline(stream, line)) {
         if (line.find("#shader") != std::string::npos) {
@@ -36,14 +75,73 @@ ShaderProgramSource Shader::ParseShader(const std::string &filepath) {
                 type = ShaderType::VERTEX;
             else if (line.find("fragment") != std::string::npos)
                 type = ShaderType::FRAGMENT;
-        } else {
+        } else if (type != ShaderType::NONE) {
+            bool version = line.find("#version") != std::string::npos;
+            if (!version && !defined[(int)type]) {
+                ss[(int)type] << defineLines;
+                defined[(int)type] = true;
+            }
             ss[(int)type] << line << '\n';
+            if (version && !defined[(int)type]) {
+                ss[(int)type] << defineLines;
+                defined[(int)type] = true;
+            }
         }
     }
 
-    stream.close();
+    return {ss[0].str(), ss[1].str(), files};
+}
+
+bool Shader::ExpandIncludes(const std::string &filepath, std::string &out,
+                            std::vector<std::string> &includeStack,
+                            std::vector<std::string> &files) {
+    if (std::find(includeStack.begin(), includeStack.end(), filepath) !=
+        includeStack.end()) {
+        std::cout << "Shader include cycle, " << filepath
+                  << " includes itself\n";
+        return false;
+    }
+
+    // Listed even if it is missing, creating it should trigger a reload
+    files.push_back(filepath);
+    std::ifstream stream(filepath);
+    if (!stream) {
+        std::cout << "Failed to open shader file " << filepath << '\n';
+        return false;
+    }
+
+    // Included paths are relative to the file including them
+    std::string directory;
+    size_t slash = filepath.find_last_of('/');
+    if (slash != std::string::npos) directory = filepath.substr(0, slash + 1);
+
+    includeStack.push_back(filepath);
+    bool ok = true;
+    std::string line;
+    while (getline(stream, line)) {
+        // Only a directive when it starts the line, "# include" is allowed
+        // like for any preprocessor directive; a commented out or quoted
+        // #include further along is left alone
+        size_t hash = line.find_first_not_of(" \t");
+        size_t include = hash == std::string::npos || line[hash] != '#'
+                             ? std::string::npos
+                             : line.find_first_not_of(" \t", hash + 1);
+        bool directive = include != std::string::npos &&
+                         line.compare(include, 7, "include") == 0;
+        size_t open = directive ? line.find('"', include + 7)
+                                : std::string::npos;
+        size_t close = line.find('"', open + 1);
+        if (open == std::string::npos || close == std::string::npos) {
+            out += line;
+            out += '\n';
+            continue;
+        }
 
-    return {ss[0].str(), ss[1].str()};
+        std::string path = directory + line.substr(open + 1, close - open - 1);
+        ok = ExpandIncludes(path, out, includeStack, files) && ok;
+    }
+    includeStack.pop_back();
+    return ok;
 }
 
 unsigned int Shader::CompileShader(unsigned int type,
@@ -80,12 +178,34 @@ unsigned int Shader::CompileShader(unsigned int type,
 }
 
 unsigned int Shader::CreateShader(const std::string &vertexShader,
-                                  const std::string &fragmentShader) {
+                                  const std::string &fragmentShader,
+                                  bool useCache) {
+    // A binary from an earlier run skips compiling and linking
+    ProgramCache &cache = ProgramCache::Get();
+    useCache = useCache && cache.IsEnabled();
+    uint64_t key = 0;
+    if (useCache) {
+        key = ProgramCache::GetKey(vertexShader, fragmentShader);
+        if (unsigned int program = cache.Load(key)) return program;
+    }
+
     // Create a program and compile two shaders
     unsigned int program;
     GLCall(program = glCreateProgram());
+    if (useCache) cache.PrepareForStore(program);
     unsigned int vs = CompileShader(GL_VERTEX_SHADER, vertexShader);
     unsigned int fs = CompileShader(GL_FRAGMENT_SHADER, fragmentShader);
+    if (!vs || !fs) {
+        // CompileShader printed why
+        if (vs) {
+            GLCall(glDeleteShader(vs));
+        }
+        if (fs) {
+            GLCall(glDeleteShader(fs));
+        }
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
 
     // Attach both shaders to program
     GLCall(glAttachShader(program, vs));
@@ -94,6 +214,21 @@ unsigned int Shader::CreateShader(const std::string &vertexShader,
     GLCall(glLinkProgram(program));
     GLCall(glValidateProgram(program));
 
+    int linked;
+    GLCall(glGetProgramiv(program, GL_LINK_STATUS, &linked));
+    if (linked == GL_FALSE) {
+        int length;
+        GLCall(glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length));
+        std::string message(length, '\0');
+        GLCall(glGetProgramInfoLog(program, length, &length, &message[0]));
+        std::cout << "Failed to link program:\n" << message << "\n";
+        GLCall(glDeleteShader(vs));
+        GLCall(glDeleteShader(fs));
+        GLCall(glDeleteProgram(program));
+        return 0;
+    }
+    if (useCache) cache.Store(key, program);
+
     // Delete shaders, we don't need them anymore
     GLCall(glDeleteShader(vs));
     GLCall(glDeleteShader(fs));
@@ -102,34 +237,253 @@ unsigned int Shader::CreateShader(const std::string &vertexShader,
     return program;
 }
 
-void Shader::Bind() const { GLCall(glUseProgram(m_RendererID)); }
-void Shader::Unbind() const { GLCall(glUseProgram(0)); }
+void Shader::Bind() const { GLState::Get().UseProgram(m_RendererID); }
+void Shader::Unbind() const { GLState::Get().UseProgram(0); }
 
-void Shader::SetUniform1i(const std::string &name, int value) {
-    GLCall(glUniform1i(GetUniformLocation(name), value));
+// Sets one uniform of the bound program to the value it has in from
+static void CopyUniform(unsigned int from, int source, int destination,
+                        GLenum type) {
+    float f[16];
+    int i[4];
+    switch (type) {
+        case GL_FLOAT:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniform1fv(destination, 1, f));
+            break;
+        case GL_FLOAT_VEC2:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniform2fv(destination, 1, f));
+            break;
+        case GL_FLOAT_VEC3:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniform3fv(destination, 1, f));
+            break;
+        case GL_FLOAT_VEC4:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniform4fv(destination, 1, f));
+            break;
+        case GL_FLOAT_MAT2:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniformMatrix2fv(destination, 1, GL_FALSE, f));
+            break;
+        case GL_FLOAT_MAT3:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniformMatrix3fv(destination, 1, GL_FALSE, f));
+            break;
+        case GL_FLOAT_MAT4:
+            GLCall(glGetUniformfv(from, source, f));
+            GLCall(glUniformMatrix4fv(destination, 1, GL_FALSE, f));
+            break;
+        case GL_INT:
+        case GL_BOOL:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_CUBE:
+            GLCall(glGetUniformiv(from, source, i));
+            GLCall(glUniform1iv(destination, 1, i));
+            break;
+        case GL_INT_VEC2:
+            GLCall(glGetUniformiv(from, source, i));
+            GLCall(glUniform2iv(destination, 1, i));
+            break;
+        case GL_INT_VEC3:
+            GLCall(glGetUniformiv(from, source, i));
+            GLCall(glUniform3iv(destination, 1, i));
+            break;
+        case GL_INT_VEC4:
+            GLCall(glGetUniformiv(from, source, i));
+            GLCall(glUniform4iv(destination, 1, i));
+            break;
+        default:
+            // Nothing we set ourselves, it keeps its default
+            break;
+    }
 }
-void Shader::SetUniform1f(const std::string &name, float value) {
-    GLCall(glUniform1f(GetUniformLocation(name), value));
+
+void Shader::Replace(unsigned int program,
+                     const std::vector<std::string> &files) {
+    // Uniforms are per program, a fresh one starts with all of them zero.
+    // Reflecting keeps every entry where it was, so before and after line up.
+    std::vector<Uniform> previous = m_Uniforms;
+    unsigned int old = std::exchange(m_RendererID, program);
+    Reflect();
+
+    GLState::Get().UseProgram(program);
+    for (size_t index = 0; index < previous.size(); ++index) {
+        const Uniform &from = previous[index];
+        const Uniform &to = m_Uniforms[index];
+        if (from.Location == -1 || to.Location == -1 || from.Type != to.Type)
+            continue;
+
+        // Each array element has its own location
+        int count = std::min(from.Size, to.Size);
+        for (int element = 0; element < count; ++element) {
+            int source = from.Location, destination = to.Location;
+            if (element > 0) {
+                std::string name =
+                    from.Name + "[" + std::to_string(element) + "]";
+                GLCall(source = glGetUniformLocation(old, name.c_str()));
+                GLCall(destination =
+                           glGetUniformLocation(program, name.c_str()));
+            }
+            if (source != -1 && destination != -1) {
+                CopyUniform(old, source, destination, to.Type);
+            }
+        }
+    }
+
+    DeletionQueue::Get().Push(GLObjectType::Program, old);
+    m_SourceFiles = files;
+}
+
+void Shader::Reflect() {
+    for (Uniform &uniform : m_Uniforms) uniform.Location = -1;
+    if (!m_RendererID) return;
+
+    int count = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count));
+    for (int index = 0; index < count; ++index) {
+        char name[256];
+        int length, size;
+        GLenum type;
+        GLCall(glGetActiveUniform(m_RendererID, index, sizeof(name), &length,
+                                  &size, &type, name));
+
+        // Arrays are reported as name[0], they are set through that location
+        std::string base(name, length);
+        if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0)
+            base.resize(base.size() - 3);
+
+        // -1 for members of uniform blocks, those aren't set one by one
+        GLCall(int location = glGetUniformLocation(m_RendererID, name));
+        if (location == -1) continue;
+
+        uint64_t hash = HashFNV1a(base);
+        auto it = std::find_if(
+            m_Uniforms.begin(), m_Uniforms.end(),
+            [hash](const Uniform &uniform) { return uniform.Hash == hash; });
+        if (it == m_Uniforms.end())
+            it = m_Uniforms.insert(m_Uniforms.end(), {hash, base, -1, 0, 0});
+        it->Location = location;
+        it->Type = type;
+        it->Size = size;
+    }
+
+    // A block reads the same buffer in every program that declares it
+    int blocks = 0;
+    GLCall(glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_BLOCKS, &blocks));
+    for (int index = 0; index < blocks; ++index) {
+        char name[256];
+        int length;
+        GLCall(glGetActiveUniformBlockName(m_RendererID, index, sizeof(name),
+                                           &length, name));
+        unsigned int binding =
+            UniformBuffer::GetBindingPoint(std::string(name, length));
+        GLCall(glUniformBlockBinding(m_RendererID, index, binding));
+    }
+}
+
+UniformHandle Shader::GetUniform(UniformName name) {
+    // A handful of uniforms per program, a scan is as quick as a hash map
+    for (size_t index = 0; index < m_Uniforms.size(); ++index) {
+        if (m_Uniforms[index].Hash == name.Hash)
+            return {(int)index, m_Uniforms[index].Type};
+    }
+
+    // Remembered without a location, a reload that adds it fills that in
+    std::cout << "Warning: uniform '" << name.Name
+              << "' unused or not found!\n";
+    m_Uniforms.push_back({name.Hash, name.Name, -1, 0, 0});
+    return {(int)m_Uniforms.size() - 1, 0};
+}
+
+#if GL_CHECK_MODE == GL_CHECK_CALLS
+static bool IsSampler(unsigned int type) {
+    switch (type) {
+        case GL_SAMPLER_1D:
+        case GL_SAMPLER_2D:
+        case GL_SAMPLER_3D:
+        case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_2D_SHADOW:
+        case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_BUFFER:
+        case GL_INT_SAMPLER_2D:
+        case GL_UNSIGNED_INT_SAMPLER_2D:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Whether a value set with glUniform of type may go into a uniform of
+// uniformType. Ints also set bools and samplers, floats also set bools.
+static bool IsAssignable(unsigned int type, unsigned int uniformType) {
+    if (type == uniformType) return true;
+    if (type == GL_INT) return uniformType == GL_BOOL || IsSampler(uniformType);
+    if (type == GL_FLOAT) return uniformType == GL_BOOL;
+    return false;
 }
+#endif
 
-void Shader::SetUniform4f(const std::string &name, float v0, float v1, float v2,
+int Shader::GetLocation(UniformHandle uniform, unsigned int type,
+                        int count) const {
+    if (uniform.Index < 0) return -1;
+    const Uniform &entry = m_Uniforms[uniform.Index];
+
+#if GL_CHECK_MODE == GL_CHECK_CALLS
+    // GL would only say GL_INVALID_OPERATION, this says which uniform
+    if (entry.Location != -1 &&
+        (!IsAssignable(type, entry.Type) || count > entry.Size)) {
+        std::cout << "Uniform '" << entry.Name << "' in " << m_FilePath
+                  << " is of type 0x" << std::hex << entry.Type << " size "
+                  << std::dec << entry.Size << ", set with type 0x" << std::hex
+                  << type << " count " << std::dec << count << std::endl;
+        ASSERT(false);
+    }
+#else
+    (void)type;
+    (void)count;
+#endif
+    return entry.Location;
+}
+
+void Shader::SetUniform1i(UniformHandle uniform, int value) {
+    GLCall(glUniform1i(GetLocation(uniform, GL_INT), value));
+}
+void Shader::SetUniform1iv(UniformHandle uniform, int count,
+                           const int *values) {
+    GLCall(glUniform1iv(GetLocation(uniform, GL_INT, count), count, values));
+}
+void Shader::SetUniform1f(UniformHandle uniform, float value) {
+    GLCall(glUniform1f(GetLocation(uniform, GL_FLOAT), value));
+}
+
+void Shader::SetUniform4f(UniformHandle uniform, float v0, float v1, float v2,
                           float v3) {
-    GLCall(glUniform4f(GetUniformLocation(name), v0, v1, v2, v3));
+    GLCall(glUniform4f(GetLocation(uniform, GL_FLOAT_VEC4), v0, v1, v2, v3));
 }
 
-void Shader::SetUniformMat4f(const std::string &name, const glm::mat4 &matrix) {
-    GLCall(glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE,
+void Shader::SetUniformMat4f(UniformHandle uniform, const glm::mat4 &matrix) {
+    GLCall(glUniformMatrix4fv(GetLocation(uniform, GL_FLOAT_MAT4), 1, GL_FALSE,
                               &matrix[0][0]));
 }
 
-int Shader::GetUniformLocation(const std::string &name) {
-    if (m_UniformLocationCache.find(name) != m_UniformLocationCache.end())
-        return m_UniformLocationCache[name];
+void Shader::SetUniform1i(UniformName name, int value) {
+    SetUniform1i(GetUniform(name), value);
+}
+void Shader::SetUniform1iv(UniformName name, int count, const int *values) {
+    SetUniform1iv(GetUniform(name), count, values);
+}
+void Shader::SetUniform1f(UniformName name, float value) {
+    SetUniform1f(GetUniform(name), value);
+}
 
-    GLCall(int location = glGetUniformLocation(m_RendererID, name.c_str()));
-    if (location == -1)
-        std::cout << "Warning: uniform '" << name << "' unused or not found!\n";
+void Shader::SetUniform4f(UniformName name, float v0, float v1, float v2,
+                          float v3) {
+    SetUniform4f(GetUniform(name), v0, v1, v2, v3);
+}
 
-    m_UniformLocationCache[name] = location;
-    return location;
-}
\ No newline at end of file
+void Shader::SetUniformMat4f(UniformName name, const glm::mat4 &matrix) {
+    SetUniformMat4f(GetUniform(name), matrix);
+}
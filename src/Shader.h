@@ -1,39 +1,136 @@
 #pragma once
 
+#include <cstdint>
+#include <map>
 #include <string>
-#include <unordered_map>
+#include <vector>
 
+#include "Hash.h"
 #include "glm/glm.hpp"
 
 struct ShaderProgramSource {
     std::string VertexSource;
     std::string FragmentSource;
+    // The shader file and everything it includes
+    std::vector<std::string> Files;
+};
+
+// Name to value, injected as #define lines right after #version. Sorted,
+// so the same set always gives the same source.
+using ShaderDefines = std::map<std::string, std::string>;
+
+// A uniform name and its hash, looking a uniform up by it never builds a
+// std::string. Only a constexpr UniformName is sure to be hashed at compile
+// time; a literal passed straight to a call is hashed when the call runs
+// unless the optimizer folds it.
+struct UniformName {
+    uint64_t Hash;
+    const char *Name;
+
+    constexpr UniformName(const char *name)
+        : Hash(HashFNV1a(name, std::char_traits<char>::length(name))),
+          Name(name) {}
+    UniformName(const std::string &name)
+        : Hash(HashFNV1a(name)), Name(name.c_str()) {}
+};
+
+// Where a uniform sits in its shader's table, take it once with GetUniform
+// and setting the uniform is an array index. Stays valid across hot reloads.
+struct UniformHandle {
+    int Index = -1;
+    // GL type when the handle was taken, 0 if the uniform wasn't found
+    unsigned int Type = 0;
+
+    inline bool IsValid() const { return Index >= 0; }
 };
 
 class Shader {
    private:
+    struct Uniform {
+        uint64_t Hash;
+        std::string Name;
+        // -1 if the current program doesn't have it (any more)
+        int Location;
+        unsigned int Type;
+        // Elements, 1 unless it is an array
+        int Size;
+    };
+
     std::string m_FilePath;
+    ShaderDefines m_Defines;
     unsigned int m_RendererID;
-    std::unordered_map<std::string, int> m_UniformLocationCache;
+    // Active uniforms of the program, read back after every link. Entries
+    // are only ever appended, so handles survive a reload.
+    std::vector<Uniform> m_Uniforms;
+    std::vector<std::string> m_SourceFiles;
 
    public:
-    Shader(const std::string &filepath);
+    // The file may #include "other.glsl" relative to itself
+    Shader(const std::string &filepath, const ShaderDefines &defines = {});
     ~Shader();
 
+    // Move-only, a copy would delete the GL object twice
+    Shader(const Shader &) = delete;
+    Shader &operator=(const Shader &) = delete;
+    Shader(Shader &&other) noexcept;
+    Shader &operator=(Shader &&other) noexcept;
+
     void Bind() const;
     void Unbind() const;
 
-    // Set uniforms
-    void SetUniform1i(const std::string &name, int value);
-    void SetUniform1f(const std::string &name, float value);
-    void SetUniform4f(const std::string &name, float v0, float v1, float v2,
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline const std::string &GetFilePath() const { return m_FilePath; }
+    inline const ShaderDefines &GetDefines() const { return m_Defines; }
+    inline const std::vector<std::string> &GetSourceFiles() const {
+        return m_SourceFiles;
+    }
+
+    // Swaps in a program made by CreateShader, e.g. after the file changed.
+    // Uniform values set on the old program carry over, the old program is
+    // deleted once the GPU is done with it.
+    void Replace(unsigned int program, const std::vector<std::string> &files);
+
+    // Warns once for a name the program doesn't use, the handle still sets
+    // it if a reload adds it
+    UniformHandle GetUniform(UniformName name);
+
+    // Set uniforms. Checked builds also check the value's type against the
+    // uniform's.
+    void SetUniform1i(UniformHandle uniform, int value);
+    void SetUniform1iv(UniformHandle uniform, int count, const int *values);
+    void SetUniform1f(UniformHandle uniform, float value);
+    void SetUniform4f(UniformHandle uniform, float v0, float v1, float v2,
                       float v3);
-    void SetUniformMat4f(const std::string &name, const glm::mat4 &matrix);
+    void SetUniformMat4f(UniformHandle uniform, const glm::mat4 &matrix);
+
+    // By name, a lookup every call. Fine outside the frame loop.
+    void SetUniform1i(UniformName name, int value);
+    void SetUniform1iv(UniformName name, int count, const int *values);
+    void SetUniform1f(UniformName name, float value);
+    void SetUniform4f(UniformName name, float v0, float v1, float v2,
+                      float v3);
+    void SetUniformMat4f(UniformName name, const glm::mat4 &matrix);
+
+    // Both only need a current context, not a Shader, so programs can be
+    // built on another thread whose context shares objects with ours
+    static ShaderProgramSource ParseShader(const std::string &filepath,
+                                           const ShaderDefines &defines);
+    // 0 if a stage fails to compile or the program fails to link
+    static unsigned int CreateShader(const std::string &vertexShader,
+                                     const std::string &fragmentShader,
+                                     bool useCache = true);
 
    private:
-    ShaderProgramSource ParseShader(const std::string &filepath);
-    unsigned int CompileShader(unsigned int type, const std::string &source);
-    unsigned int CreateShader(const std::string &vertexShader,
-                              const std::string &fragmentShader);
-    int GetUniformLocation(const std::string &name);
+    // Appends the file to out with #include lines replaced by the files
+    // they name. includeStack holds the files being expanded, to stop cycles.
+    static bool ExpandIncludes(const std::string &filepath, std::string &out,
+                               std::vector<std::string> &includeStack,
+                               std::vector<std::string> &files);
+    static unsigned int CompileShader(unsigned int type,
+                                      const std::string &source);
+    // Fills in the table for the current program and points its uniform
+    // blocks at their binding points
+    void Reflect();
+    int GetLocation(UniformHandle uniform, unsigned int type,
+                    int count = 1) const;
 };
\ No newline at end of file
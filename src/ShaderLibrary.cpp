@@ -0,0 +1,62 @@
+#include "ShaderLibrary.h"
+
+#include <chrono>
+
+#include "Hash.h"
+
+Shader &ShaderLibrary::Get(const std::string &filepath,
+                           const ShaderDefines &defines) {
+    m_Stats.Requests++;
+
+    Variant &variant = m_Variants[{filepath, HashDefines(defines)}];
+    if (variant.Program) return *variant.Program;
+
+    auto start = std::chrono::steady_clock::now();
+    variant.FilePath = filepath;
+    variant.Defines = defines;
+    variant.Program = std::make_unique<Shader>(filepath, defines);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    variant.CompileSeconds = elapsed.count();
+    m_Stats.Variants++;
+    m_Stats.CompileSeconds += elapsed.count();
+    return *variant.Program;
+}
+
+uint64_t ShaderLibrary::HashDefines(const ShaderDefines &defines) {
+    // Terminators keep {"AB", ""} and {"A", "B"} apart
+    uint64_t hash = FNVOffsetBasis;
+    for (const auto &define : defines) {
+        hash = HashFNV1a(define.first.c_str(), define.first.size() + 1, hash);
+        hash = HashFNV1a(define.second.c_str(), define.second.size() + 1, hash);
+    }
+    return hash;
+}
+
+unsigned int ShaderLibrary::GetVariantCount(const std::string &filepath) const {
+    unsigned int count = 0;
+    for (const auto &entry : m_Variants)
+        if (entry.first.first == filepath) count++;
+    return count;
+}
+
+void ShaderLibrary::PrintStats(std::ostream &out) const {
+    out << "Shaders: " << m_Stats.Variants << " variants for "
+        << m_Stats.Requests << " requests, " << m_Stats.CompileSeconds * 1000.0
+        << " ms building them\n";
+
+    // Variants of a file are next to each other in the map
+    auto it = m_Variants.begin();
+    while (it != m_Variants.end()) {
+        const std::string &filepath = it->first.first;
+        unsigned int count = 0;
+        double seconds = 0.0;
+        for (; it != m_Variants.end() && it->first.first == filepath; ++it) {
+            count++;
+            seconds += it->second.CompileSeconds;
+        }
+        out << "  " << filepath << ": " << count << " variants, "
+            << seconds * 1000.0 << " ms\n";
+    }
+}
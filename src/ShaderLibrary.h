@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+
+#include "Shader.h"
+
+// Every shader the app uses, one program per file and define set. Asking
+// for a variant that was built before returns the same Shader, so each
+// permutation is compiled once no matter how many places use it. Counts and
+// compile times per file show where permutations pile up.
+//
+//   Shader& lit = library.Get("res/shaders/Basic.shader", {{"FOG", "1"}});
+class ShaderLibrary {
+   public:
+    struct Stats {
+        unsigned int Variants = 0;
+        // Get calls, the ones that didn't compile were shared
+        unsigned int Requests = 0;
+        // Spent building variants, including binary cache loads
+        double CompileSeconds = 0.0;
+    };
+
+    struct Variant {
+        std::string FilePath;
+        ShaderDefines Defines;
+        double CompileSeconds = 0.0;
+        // Shaders don't move once built, references to them stay valid
+        std::unique_ptr<Shader> Program;
+    };
+
+   private:
+    // File and hash of the define set
+    std::map<std::pair<std::string, uint64_t>, Variant> m_Variants;
+    Stats m_Stats;
+
+   public:
+    Shader &Get(const std::string &filepath, const ShaderDefines &defines = {});
+
+    // Identifies a define set, the same names and values give the same hash
+    static uint64_t HashDefines(const ShaderDefines &defines);
+
+    unsigned int GetVariantCount(const std::string &filepath) const;
+    inline const Stats &GetStats() const { return m_Stats; }
+    inline const std::map<std::pair<std::string, uint64_t>, Variant> &
+    GetVariants() const {
+        return m_Variants;
+    }
+
+    // One line per file with its variant count and compile time
+    void PrintStats(std::ostream &out) const;
+};
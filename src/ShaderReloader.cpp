@@ -0,0 +1,137 @@
+#include "ShaderReloader.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "DeletionQueue.h"
+#include "ShaderLibrary.h"
+
+ShaderReloader::ShaderReloader(ShaderLibrary& library,
+                               const std::string& directory,
+                               std::function<void()> makeCurrent,
+                               std::function<void()> releaseCurrent)
+    : m_Library(library),
+      m_Watcher(directory),
+      m_MakeCurrent(std::move(makeCurrent)),
+      m_ReleaseCurrent(std::move(releaseCurrent)),
+      m_Stopping(false) {}
+
+ShaderReloader::~ShaderReloader() {
+    if (m_Thread.joinable()) Stop();
+}
+
+void ShaderReloader::Start() {
+    m_Stopping = false;
+    m_Thread = std::thread(&ShaderReloader::Run, this);
+}
+
+void ShaderReloader::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stopping = true;
+    }
+    m_Condition.notify_all();
+    if (m_Thread.joinable()) m_Thread.join();
+
+    // Built but never swapped in
+    m_Pending.insert(m_Pending.end(), m_Results.begin(), m_Results.end());
+    m_Results.clear();
+    for (const Result& result : m_Pending) {
+        DeletionQueue::Get().Push(GLObjectType::Program, result.Program);
+        if (result.Fence) {
+            GLCall(glDeleteSync(result.Fence));
+        }
+    }
+    m_Pending.clear();
+}
+
+void ShaderReloader::Update() {
+    for (const std::string& path : m_Watcher.Poll()) Queue(path);
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Pending.insert(m_Pending.end(), m_Results.begin(), m_Results.end());
+        m_Results.clear();
+    }
+
+    // In order, so the last edit of a file is the one that stays
+    for (auto it = m_Pending.begin(); it != m_Pending.end();) {
+        if (!it->Program) {
+            std::cout << "Keeping the previous program for "
+                      << it->Target->GetFilePath() << '\n';
+            m_Stats.Failed++;
+            it = m_Pending.erase(it);
+            continue;
+        }
+
+        GLenum status;
+        GLCall(status = glClientWaitSync(it->Fence, 0, 0));
+        if (status == GL_TIMEOUT_EXPIRED) {
+            // Still building on the GPU side, try again next frame. Later
+            // results can't overtake this one.
+            break;
+        }
+
+        GLCall(glDeleteSync(it->Fence));
+        it->Target->Replace(it->Program, it->Files);
+        std::cout << "Reloaded " << it->Target->GetFilePath() << '\n';
+        m_Stats.Reloaded++;
+        it = m_Pending.erase(it);
+    }
+}
+
+void ShaderReloader::Queue(const std::string& path) {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    for (const auto& entry : m_Library.GetVariants()) {
+        Shader* shader = entry.second.Program.get();
+        const std::vector<std::string>& files = shader->GetSourceFiles();
+        bool reads = std::any_of(files.begin(), files.end(), [&](auto& file) {
+            return FileWatcher::Normalize(file) == path;
+        });
+        if (!reads) continue;
+
+        // A rebuild that hasn't started yet will pick up this change too
+        bool queued =
+            std::any_of(m_Jobs.begin(), m_Jobs.end(),
+                        [&](auto& job) { return job.Target == shader; });
+        if (!queued)
+            m_Jobs.push_back(
+                {shader, entry.second.FilePath, entry.second.Defines});
+    }
+    m_Condition.notify_one();
+}
+
+void ShaderReloader::Run() {
+    m_MakeCurrent();
+
+    while (true) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_Condition.wait(
+                lock, [this] { return !m_Jobs.empty() || m_Stopping; });
+            if (m_Stopping) break;
+            job = m_Jobs.front();
+            m_Jobs.pop_front();
+        }
+
+        // Not stored in the program cache, a file saved mid-edit is rarely
+        // worth keeping around
+        ShaderProgramSource source =
+            Shader::ParseShader(job.FilePath, job.Defines);
+        unsigned int program = Shader::CreateShader(
+            source.VertexSource, source.FragmentSource, false);
+
+        GLsync fence = nullptr;
+        if (program) {
+            GLCall(fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+        }
+        // Nothing else is going to submit this context's commands
+        GLCall(glFlush());
+
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Results.push_back({job.Target, program, source.Files, fence});
+    }
+
+    m_ReleaseCurrent();
+}
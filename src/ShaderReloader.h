@@ -0,0 +1,94 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FileWatcher.h"
+#include "Renderer.h"
+#include "Shader.h"
+
+class ShaderLibrary;
+
+// Rebuilds the library's shaders when their files change, without the
+// render loop ever waiting for a compile. A worker thread with its own
+// context, sharing objects with the render context, parses and compiles;
+// Update on the render thread swaps a finished program into its Shader once
+// the GPU side is done too. A program that fails to build is dropped and the
+// old one stays live.
+//
+//   ShaderReloader reloader(library, "res/shaders", makeCurrent, release);
+//   reloader.Start();
+//   ... every frame on the GL thread: reloader.Update();
+class ShaderReloader {
+   public:
+    struct Stats {
+        unsigned int Reloaded = 0;
+        unsigned int Failed = 0;
+    };
+
+   private:
+    struct Job {
+        Shader* Target;
+        std::string FilePath;
+        ShaderDefines Defines;
+    };
+
+    struct Result {
+        Shader* Target;
+        // 0 when the build failed
+        unsigned int Program;
+        std::vector<std::string> Files;
+        // Signals once the worker's commands have run, before that the
+        // program may not be complete as seen from another context
+        GLsync Fence;
+    };
+
+    ShaderLibrary& m_Library;
+    FileWatcher m_Watcher;
+    std::function<void()> m_MakeCurrent;
+    std::function<void()> m_ReleaseCurrent;
+
+    std::thread m_Thread;
+    std::mutex m_Mutex;
+    std::condition_variable m_Condition;
+    std::deque<Job> m_Jobs;
+    std::vector<Result> m_Results;
+    bool m_Stopping;
+
+    // Only touched by the GL thread
+    std::vector<Result> m_Pending;
+    Stats m_Stats;
+
+   public:
+    // makeCurrent and releaseCurrent are called on the worker thread, for a
+    // context created to share objects with the one Update runs on
+    ShaderReloader(ShaderLibrary& library, const std::string& directory,
+                   std::function<void()> makeCurrent,
+                   std::function<void()> releaseCurrent);
+    ~ShaderReloader();
+
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    void Start();
+    // Joins the worker, call with the render context current so programs
+    // still in flight can be dropped
+    void Stop();
+
+    // Call once per frame on the thread that draws with the library's
+    // shaders. Queues rebuilds for changed files and swaps in finished
+    // programs, never waits for either.
+    void Update();
+
+    inline const Stats& GetStats() const { return m_Stats; }
+
+   private:
+    void Run();
+    // Rebuilds every variant that reads path
+    void Queue(const std::string& path);
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstring>
+
+#include "Renderer.h"
+#include "glm/glm.hpp"
+
+// Writes values the way a layout(std140) uniform block lays them out, so
+// the C++ side only lists the members in declaration order:
+//   vec2 aligns to 8 bytes, vec3 and vec4 to 16
+//   a mat3 is three vec4 columns, a mat4 four
+//   every array element starts on 16 bytes and takes at least 16
+//   the block as a whole is padded to a multiple of 16
+// With data nullptr nothing is written, which measures a block:
+//   Std140Writer size(nullptr, 0);
+//   size.Write(glm::mat4()); size.Write(glm::vec3());
+//   unsigned int bytes = size.GetSize();
+class Std140Writer {
+   private:
+    unsigned char* m_Data;
+    unsigned int m_Capacity;
+    unsigned int m_Offset;
+
+   public:
+    Std140Writer(void* data, unsigned int capacity)
+        : m_Data((unsigned char*)data), m_Capacity(capacity), m_Offset(0) {}
+
+    void Write(float value) { Put(&value, sizeof(value), 4); }
+    void Write(int value) { Put(&value, sizeof(value), 4); }
+    // GLSL bools are 4 bytes
+    void Write(bool value) { Write((int)value); }
+    void Write(const glm::vec2& value) { Put(&value, sizeof(value), 8); }
+    void Write(const glm::vec3& value) { Put(&value, sizeof(value), 16); }
+    void Write(const glm::vec4& value) { Put(&value, sizeof(value), 16); }
+    void Write(const glm::mat3& value) {
+        for (int column = 0; column < 3; ++column) Write(value[column]);
+        m_Offset = Align(m_Offset, 16);
+    }
+    void Write(const glm::mat4& value) { Put(&value, sizeof(value), 16); }
+
+    // An array member, each element padded out to 16 bytes
+    template <typename T>
+    void WriteArray(const T* values, unsigned int count) {
+        for (unsigned int i = 0; i < count; ++i) {
+            m_Offset = Align(m_Offset, 16);
+            Write(values[i]);
+        }
+        m_Offset = Align(m_Offset, 16);
+    }
+
+    // Bytes the block takes so far, padding included
+    inline unsigned int GetSize() const { return Align(m_Offset, 16); }
+    inline unsigned int GetOffset() const { return m_Offset; }
+
+    static constexpr unsigned int Align(unsigned int offset,
+                                        unsigned int alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+   private:
+    void Put(const void* value, unsigned int size, unsigned int alignment) {
+        m_Offset = Align(m_Offset, alignment);
+        if (m_Data) {
+            ASSERT(m_Offset + size <= m_Capacity);
+            std::memcpy(m_Data + m_Offset, value, size);
+        }
+        m_Offset += size;
+    }
+};
@@ -0,0 +1,139 @@
+#include "StreamingBuffer.h"
+
+#include <cstring>
+
+#include "GLState.h"
+#include "GPUMemory.h"
+
+StreamingBuffer::StreamingBuffer(unsigned int regionSize,
+                                 unsigned int regionCount)
+    : m_RendererID(0),
+      m_RegionSize(regionSize),
+      m_RegionCount(regionCount),
+      m_Persistent(GLEW_ARB_buffer_storage),
+      m_Data(nullptr),
+      m_Region(0),
+      m_RegionOffset(0),
+      m_Fences(regionCount, nullptr) {
+    unsigned int size = m_RegionSize * m_RegionCount;
+
+    m_RendererID = BufferCreate();
+    GPUMemory::Get().Track(MemoryCategory::StreamingBuffer, m_RendererID, size);
+
+    if (!m_Persistent) {
+        BufferAllocate(m_RendererID, size, BufferUsage::Stream);
+        m_Data = new unsigned char[size];
+        return;
+    }
+
+    // Immutable storage, mapped once for the lifetime of the buffer.
+    // Coherent means no explicit flushes, writes show up on their own.
+    GLbitfield flags =
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    if (GLHasDirectStateAccess()) {
+        GLCall(glNamedBufferStorage(m_RendererID, size, nullptr, flags));
+        GLCall(m_Data = (unsigned char*)glMapNamedBufferRange(
+                   m_RendererID, 0, size, flags));
+    } else {
+        Bind();
+        GLCall(glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags));
+        GLCall(m_Data = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0,
+                                                         size, flags));
+    }
+}
+
+StreamingBuffer::~StreamingBuffer() {
+    for (GLsync fence : m_Fences) {
+        if (fence) {
+            GLCall(glDeleteSync(fence));
+        }
+    }
+
+    if (m_Persistent && GLHasDirectStateAccess()) {
+        GLCall(glUnmapNamedBuffer(m_RendererID));
+    } else if (m_Persistent) {
+        Bind();
+        GLCall(glUnmapBuffer(GL_ARRAY_BUFFER));
+    } else {
+        delete[] m_Data;
+    }
+
+    GPUMemory::Get().Untrack(MemoryCategory::StreamingBuffer, m_RendererID);
+    GLState::Get().OnDeleteBuffer(m_RendererID);
+    GLCall(glDeleteBuffers(1, &m_RendererID));
+}
+
+StreamingBuffer::Allocation StreamingBuffer::Allocate(unsigned int size,
+                                                      unsigned int alignment) {
+    ASSERT(size <= m_RegionSize);
+
+    // Offsets are absolute, align them within the whole buffer
+    unsigned int base = m_Region * m_RegionSize;
+    unsigned int offset = base + m_RegionOffset;
+    offset = (offset + alignment - 1) / alignment * alignment;
+
+    if (offset + size > base + m_RegionSize) {
+        NextRegion();
+        base = m_Region * m_RegionSize;
+        offset = (base + alignment - 1) / alignment * alignment;
+        ASSERT(offset + size <= base + m_RegionSize);
+    }
+
+    m_RegionOffset = offset + size - base;
+    m_Stats.BytesAllocated += size;
+    return {m_Data + offset, offset, size};
+}
+
+void StreamingBuffer::Commit(const Allocation& allocation) {
+    // Coherent mapping, the GPU already sees what was written
+    if (m_Persistent) return;
+
+    BufferWrite(m_RendererID, allocation.Offset, allocation.Size,
+                allocation.Data);
+}
+
+void StreamingBuffer::EndFrame() {
+    if (m_RegionOffset) NextRegion();
+}
+
+void StreamingBuffer::NextRegion() {
+    // Draws reading the region we leave are all issued by now
+    if (m_Fences[m_Region]) {
+        GLCall(glDeleteSync(m_Fences[m_Region]));
+    }
+    GLCall(m_Fences[m_Region] =
+               glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+    m_Region = (m_Region + 1) % m_RegionCount;
+    m_RegionOffset = 0;
+
+    GLsync fence = m_Fences[m_Region];
+    if (!fence) return;
+
+    // Usually long signaled, only count it as a stall if we actually wait
+    GLenum status;
+    GLCall(status = glClientWaitSync(fence, 0, 0));
+    if (status == GL_TIMEOUT_EXPIRED) {
+        m_Stats.Stalls++;
+        do {
+            GLCall(status = glClientWaitSync(
+                       fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000));
+        } while (status == GL_TIMEOUT_EXPIRED);
+    }
+
+    GLCall(glDeleteSync(fence));
+    m_Fences[m_Region] = nullptr;
+}
+
+void StreamingBuffer::Bind() const {
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void StreamingBuffer::Unbind() const {
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StreamingBuffer::SetDebugName(const std::string& name) {
+    GPUMemory::Get().SetName(MemoryCategory::StreamingBuffer, m_RendererID,
+                             name);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "BufferUsage.h"
+#include "Renderer.h"
+
+// Ring of GL buffer memory for data rewritten every frame. The buffer is
+// split into regions, each guarded by a fence: a region is only written
+// again once the GPU has finished every draw that read from it, so CPU
+// writes and GPU reads never wait on each other in the common case.
+//
+// With GL 4.4 / ARB_buffer_storage the whole buffer stays mapped (persistent,
+// coherent) and Allocate hands out pointers straight into it. Without it
+// (macOS) writes go to a CPU copy that Commit uploads with glBufferSubData.
+class StreamingBuffer {
+   public:
+    struct Allocation {
+        // Where to write, valid until Commit
+        void* Data;
+        // Byte offset of Data in the GL buffer, what draws should read from
+        unsigned int Offset;
+        unsigned int Size;
+    };
+
+    struct Stats {
+        // Times we had to wait for the GPU to free a region
+        unsigned int Stalls = 0;
+        unsigned int BytesAllocated = 0;
+    };
+
+   private:
+    unsigned int m_RendererID;
+    unsigned int m_RegionSize;
+    unsigned int m_RegionCount;
+    bool m_Persistent;
+
+    // Whole buffer, mapped when persistent, CPU staging otherwise
+    unsigned char* m_Data;
+
+    unsigned int m_Region;
+    unsigned int m_RegionOffset;
+    std::vector<GLsync> m_Fences;
+
+    Stats m_Stats;
+
+   public:
+    // regionCount is how many frames the CPU can be ahead of the GPU
+    StreamingBuffer(unsigned int regionSize, unsigned int regionCount = 3);
+    ~StreamingBuffer();
+
+    // Owns a mapping and fences, not meant to be copied or moved
+    StreamingBuffer(const StreamingBuffer&) = delete;
+    StreamingBuffer& operator=(const StreamingBuffer&) = delete;
+
+    // size bytes with the offset aligned to alignment, which should be the
+    // vertex stride if the data is drawn with a base vertex. Moves on to the
+    // next region when the current one is full.
+    Allocation Allocate(unsigned int size, unsigned int alignment = 4);
+    // Makes the written data visible to GL, call before drawing from it
+    void Commit(const Allocation& allocation);
+
+    // Fences everything written since the last call, the next frame starts
+    // in a fresh region
+    void EndFrame();
+
+    void Bind() const;
+    void Unbind() const;
+
+    // Name the buffer's memory is reported under, see GPUMemory
+    void SetDebugName(const std::string& name);
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline bool IsPersistent() const { return m_Persistent; }
+    inline const Stats& GetStats() const { return m_Stats; }
+    inline void ResetStats() { m_Stats = Stats(); }
+
+   private:
+    void NextRegion();
+};
@@ -1,33 +1,97 @@
 #include "Texture.h"
 
+#include <iostream>
+#include <utility>
+
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "GPUMemory.h"
+
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image/stb_image.h"
 
+// internalFormat - how OpenGL will store the texture data
+// format - format of the data we provide, one byte per channel
+static GLenum GetInternalFormat(int channels) {
+    switch (channels) {
+        case 1:
+            return GL_R8;
+        case 2:
+            return GL_RG8;
+        case 3:
+            return GL_RGB8;
+    }
+    return GL_RGBA8;
+}
+
+static GLenum GetFormat(int channels) {
+    switch (channels) {
+        case 1:
+            return GL_RED;
+        case 2:
+            return GL_RG;
+        case 3:
+            return GL_RGB;
+    }
+    return GL_RGBA;
+}
+
+// GL expects every row to start on 4 bytes by default, which rows of one to
+// three channel images often don't
+static void SetUnpackAlignment(int width, int bpp) {
+    GLCall(glPixelStorei(GL_UNPACK_ALIGNMENT, (width * bpp) % 4 ? 1 : 4));
+}
+
 /*
 LocalBuffer is a pointer to RAM where texture is stored
-BPP - bits per pixel?
+BPP - bytes per pixel, stb_image gives us the channels in the file
 
 */
-Texture::Texture(const std::string& path)
+Texture::Texture(const std::string& path, bool mipmaps)
     : m_RendererID(0),
       m_FilePath(path),
       m_LocalBuffer(nullptr),
       m_Width(0),
       m_Height(0),
-      m_BPP(0) {
+      m_BPP(0),
+      m_Levels(1) {
     // Flip the texture because OpenGL expects pixels to
     // start at the bottom left, not the top left
     stbi_set_flip_vertically_on_load(1);
 
-    // Last parameter is 4 because we want rgba
-    m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+    // Last parameter is 0 to get the channels the file has
+    m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 0);
+    if (!m_LocalBuffer) {
+        std::cout << "Failed to load texture " << path << '\n';
+        m_BPP = 4;
+    }
+    if (mipmaps) m_Levels = GPUMemory::GetMipLevels(m_Width, m_Height);
 
+    Create(m_LocalBuffer);
+    SetDebugName(path);
+
+    if (m_LocalBuffer) stbi_image_free(m_LocalBuffer);
+    m_LocalBuffer = nullptr;
+}
+
+Texture::Texture(int width, int height, const void* data, bool mipmaps)
+    : m_RendererID(0),
+      m_LocalBuffer(nullptr),
+      m_Width(width),
+      m_Height(height),
+      m_BPP(4),
+      m_Levels(mipmaps ? GPUMemory::GetMipLevels(width, height) : 1) {
+    Create(data);
+}
+
+void Texture::Create(const void* data) {
     GLCall(glGenTextures(1, &m_RendererID));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    GLState::Get().BindTextureForEdit(0, m_RendererID);
 
     // Minification filter is used when texture needs to be sampled down
     // to be rendered on screen
-    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+                           m_Levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR));
     // Sometimes we might need to render the texture on area which is larger
     // than the texture itself
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
@@ -35,23 +99,86 @@ Texture::Texture(const std::string& path)
     // GL_CLAMP - don't extend the area
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
     GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+    GLCall(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, m_Levels - 1));
+
+    // Grey is stored in red, spread it to rgb (and green to alpha for
+    // grey-alpha) so shaders see the same colors as with RGBA
+    if (m_BPP <= 2) {
+        GLint swizzle[] = {GL_RED, GL_RED, GL_RED,
+                           m_BPP == 2 ? GL_GREEN : GL_ONE};
+        GLCall(glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA,
+                                swizzle));
+    }
 
     // Send the data to OpenGL
-    // internalFormat - how OpenGL will store the texture data
-    // format - format of data you provide (m_LocalBuffer)
-    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0,
-                        GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer));
+    SetUnpackAlignment(m_Width, m_BPP);
+    GLCall(glTexImage2D(GL_TEXTURE_2D, 0, GetInternalFormat(m_BPP), m_Width,
+                        m_Height, 0, GetFormat(m_BPP), GL_UNSIGNED_BYTE,
+                        data));
+    if (m_Levels > 1) {
+        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+    }
 
     Unbind();
 
-    if (m_LocalBuffer) stbi_image_free(m_LocalBuffer);
+    GPUMemory::Get().Track(
+        MemoryCategory::Texture, m_RendererID,
+        GPUMemory::GetTextureSize(m_Width, m_Height, m_BPP, m_Levels));
 }
 
-Texture::~Texture() { GLCall(glDeleteTextures(1, &m_RendererID)); }
+Texture::~Texture() {
+    GPUMemory::Get().Untrack(MemoryCategory::Texture, m_RendererID);
+    DeletionQueue::Get().Push(GLObjectType::Texture, m_RendererID);
+}
+
+Texture::Texture(Texture&& other) noexcept
+    : m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_FilePath(std::move(other.m_FilePath)),
+      m_LocalBuffer(nullptr),
+      m_Width(other.m_Width),
+      m_Height(other.m_Height),
+      m_BPP(other.m_BPP),
+      m_Levels(other.m_Levels) {}
+
+// Our old texture goes to other and is deleted along with it
+Texture& Texture::operator=(Texture&& other) noexcept {
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_FilePath, other.m_FilePath);
+    std::swap(m_Width, other.m_Width);
+    std::swap(m_Height, other.m_Height);
+    std::swap(m_BPP, other.m_BPP);
+    std::swap(m_Levels, other.m_Levels);
+    return *this;
+}
 
 void Texture::Bind(unsigned int slot) const {
-    GLCall(glActiveTexture(GL_TEXTURE0 + slot));
-    GLCall(glBindTexture(GL_TEXTURE_2D, m_RendererID));
+    GLState::Get().BindTexture(slot, m_RendererID);
+}
+
+void Texture::Unbind(unsigned int slot) const {
+    GLState::Get().BindTexture(slot, 0);
 }
 
-void Texture::Unbind() const { GLCall(glBindTexture(GL_TEXTURE_2D, 0)); }
+void Texture::SetData(const void* data) {
+    SetUnpackAlignment(m_Width, m_BPP);
+    if (GLHasDirectStateAccess()) {
+        GLCall(glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height,
+                                   GetFormat(m_BPP), GL_UNSIGNED_BYTE, data));
+        if (m_Levels > 1) {
+            GLCall(glGenerateTextureMipmap(m_RendererID));
+        }
+        return;
+    }
+
+    // Edits go to the active unit, which Bind doesn't always switch to
+    GLState::Get().BindTextureForEdit(0, m_RendererID);
+    GLCall(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, m_Width, m_Height,
+                           GetFormat(m_BPP), GL_UNSIGNED_BYTE, data));
+    if (m_Levels > 1) {
+        GLCall(glGenerateMipmap(GL_TEXTURE_2D));
+    }
+}
+
+void Texture::SetDebugName(const std::string& name) {
+    GPUMemory::Get().SetName(MemoryCategory::Texture, m_RendererID, name);
+}
@@ -7,15 +7,43 @@ class Texture {
     unsigned int m_RendererID;
     std::string m_FilePath;
     unsigned char* m_LocalBuffer;
+    // m_BPP is bytes per pixel, one per channel the image has
     int m_Width, m_Height, m_BPP;
+    int m_Levels;
 
    public:
-    Texture(const std::string& path);
+    // Keeps the channel count of the file instead of expanding everything
+    // to RGBA, grey and grey-alpha images still sample as grey. mipmaps
+    // builds the full chain, which costs another third of the memory.
+    Texture(const std::string& path, bool mipmaps = false);
+    // RGBA8 texture from pixels already in memory
+    Texture(int width, int height, const void* data, bool mipmaps = false);
     ~Texture();
 
+    // Move-only, a copy would delete the GL object twice
+    Texture(const Texture&) = delete;
+    Texture& operator=(const Texture&) = delete;
+    Texture(Texture&& other) noexcept;
+    Texture& operator=(Texture&& other) noexcept;
+
     void Bind(unsigned int slot = 0) const;
-    void Unbind() const;
+    void Unbind(unsigned int slot = 0) const;
+
+    // Replaces the whole image, data has the texture's size and channels.
+    // Mip levels are rebuilt from it.
+    void SetData(const void* data);
+
+    // Name the texture's memory is reported under, see GPUMemory. Textures
+    // loaded from a file start out named after it.
+    void SetDebugName(const std::string& name);
 
+    inline unsigned int GetRendererID() const { return m_RendererID; }
     inline int GetWidth() const { return m_Width; }
     inline int GetHeight() const { return m_Height; }
+    inline int GetChannels() const { return m_BPP; }
+    inline int GetMipLevels() const { return m_Levels; }
+
+   private:
+    // Sampler state, storage for every level and the first upload
+    void Create(const void* data);
 };
@@ -0,0 +1,75 @@
+#include "UniformBuffer.h"
+
+#include <iostream>
+#include <map>
+#include <utility>
+
+#include "DeletionQueue.h"
+#include "GPUMemory.h"
+#include "Renderer.h"
+
+UniformBuffer::UniformBuffer(const std::string& block, unsigned int size)
+    : m_Size(size), m_Binding(GetBindingPoint(block)) {
+    m_RendererID = BufferCreate();
+    BufferAllocate(m_RendererID, size, BufferUsage::Dynamic);
+    GPUMemory::Get().Track(MemoryCategory::UniformBuffer, m_RendererID, size);
+    GPUMemory::Get().SetName(MemoryCategory::UniformBuffer, m_RendererID,
+                             block);
+}
+
+UniformBuffer::~UniformBuffer() {
+    GPUMemory::Get().Untrack(MemoryCategory::UniformBuffer, m_RendererID);
+    DeletionQueue::Get().Push(GLObjectType::Buffer, m_RendererID);
+}
+
+UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+    : m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_Size(other.m_Size),
+      m_Binding(other.m_Binding) {}
+
+// Our old buffer goes to other and is deleted along with it
+UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept {
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_Size, other.m_Size);
+    std::swap(m_Binding, other.m_Binding);
+    return *this;
+}
+
+void UniformBuffer::SetData(const void* data, unsigned int size) {
+    ASSERT(size <= m_Size);
+    BufferAllocate(m_RendererID, m_Size, BufferUsage::Dynamic);
+    BufferWrite(m_RendererID, 0, size, data);
+}
+
+void UniformBuffer::Bind() const {
+    GLCall(glBindBufferBase(GL_UNIFORM_BUFFER, m_Binding, m_RendererID));
+}
+
+void UniformBuffer::SetDebugName(const std::string& name) {
+    GPUMemory::Get().SetName(MemoryCategory::UniformBuffer, m_RendererID,
+                             name);
+}
+
+unsigned int UniformBuffer::GetBindingPoint(const std::string& block) {
+    // Only shaders and buffers on the GL thread ask, no lock needed
+    static std::map<std::string, unsigned int> bindings;
+    auto it = bindings.find(block);
+    if (it != bindings.end()) return it->second;
+
+    // GL 3.3 guarantees 36 (GL_MAX_UNIFORM_BUFFER_BINDINGS)
+    unsigned int binding = bindings.size();
+    if (binding >= 36)
+        std::cout << "Warning: uniform block " << block
+                  << " gets binding point " << binding
+                  << ", more than GL guarantees\n";
+    bindings[block] = binding;
+    return binding;
+}
+
+unsigned int UniformBuffer::GetOffsetAlignment() {
+    static int alignment = 0;
+    if (!alignment) {
+        GLCall(glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment));
+    }
+    return alignment;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+
+#include "BufferUsage.h"
+
+// A GL_UNIFORM_BUFFER backing one uniform block, e.g. per-frame camera data
+// that every shader reads instead of each program getting its own copy
+// through glUniform.
+//
+// Blocks are matched to buffers by name. GetBindingPoint hands every block
+// name its own binding point, shaders point their blocks there after every
+// link (see Shader::Reflect) and the buffer for a block binds there too.
+class UniformBuffer {
+   private:
+    unsigned int m_RendererID;
+    unsigned int m_Size;
+    unsigned int m_Binding;
+
+   public:
+    // size is the block's std140 size, see Std140Writer
+    UniformBuffer(const std::string& block, unsigned int size);
+    ~UniformBuffer();
+
+    // Move-only, a copy would delete the GL object twice
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+    UniformBuffer(UniformBuffer&& other) noexcept;
+    UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+    // Replaces the whole block. The old storage is orphaned first, so this
+    // never waits for draws still reading the previous frame's values.
+    void SetData(const void* data, unsigned int size);
+
+    // Makes the block's binding point read from this buffer
+    void Bind() const;
+
+    // Name the buffer's memory is reported under, see GPUMemory
+    void SetDebugName(const std::string& name);
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline unsigned int GetSize() const { return m_Size; }
+    inline unsigned int GetBinding() const { return m_Binding; }
+
+    // The binding point for blocks called block, the same one for every
+    // shader. Assigned on first use.
+    static unsigned int GetBindingPoint(const std::string& block);
+    // glBindBufferRange offsets have to be a multiple of this
+    static unsigned int GetOffsetAlignment();
+};
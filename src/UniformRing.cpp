@@ -0,0 +1,26 @@
+#include "UniformRing.h"
+
+#include "UniformBuffer.h"
+
+UniformRing::UniformRing(const std::string& block, unsigned int blockSize,
+                         unsigned int blocksPerFrame, unsigned int frames)
+    : m_Binding(UniformBuffer::GetBindingPoint(block)),
+      m_BlockSize(blockSize),
+      m_Stride(Std140Writer::Align(blockSize,
+                                   UniformBuffer::GetOffsetAlignment())),
+      m_Buffer(m_Stride * blocksPerFrame, frames) {
+    m_Buffer.SetDebugName(block);
+}
+
+UniformRing::Slot UniformRing::Allocate() {
+    StreamingBuffer::Allocation allocation =
+        m_Buffer.Allocate(m_BlockSize, UniformBuffer::GetOffsetAlignment());
+    return {Std140Writer(allocation.Data, allocation.Size), allocation};
+}
+
+void UniformRing::Bind(const Slot& slot) {
+    m_Buffer.Commit(slot.Allocation);
+    GLCall(glBindBufferRange(GL_UNIFORM_BUFFER, m_Binding,
+                             m_Buffer.GetRendererID(), slot.Allocation.Offset,
+                             slot.Allocation.Size));
+}
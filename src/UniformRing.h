@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+
+#include "Std140.h"
+#include "StreamingBuffer.h"
+
+// Per-object uniform blocks written into a StreamingBuffer, one slot per
+// draw. Each draw binds its slot's range of the shared buffer to the block's
+// binding point, the GL counterpart of a dynamic offset, so per-object data
+// is one glBindBufferRange instead of a glUniform call per member.
+//
+//   UniformRing objects("Object", blockSize, 1024);
+//   for every object:
+//       UniformRing::Slot slot = objects.Allocate();
+//       slot.Writer.Write(model); slot.Writer.Write(color);
+//       objects.Bind(slot);
+//       renderer.Draw(...);
+//   objects.EndFrame();
+class UniformRing {
+   public:
+    struct Slot {
+        // Writes the block's members into the slot, in declaration order
+        Std140Writer Writer;
+        StreamingBuffer::Allocation Allocation;
+    };
+
+   private:
+    unsigned int m_Binding;
+    unsigned int m_BlockSize;
+    // Block size rounded up to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT
+    unsigned int m_Stride;
+    StreamingBuffer m_Buffer;
+
+   public:
+    // blocksPerFrame slots are reused once the GPU is done with them, more
+    // than that in one frame waits for the GPU
+    UniformRing(const std::string& block, unsigned int blockSize,
+                unsigned int blocksPerFrame, unsigned int frames = 3);
+
+    Slot Allocate();
+    // Uploads the slot if needed and points the block's binding at it, the
+    // next draw reads this slot
+    void Bind(const Slot& slot);
+
+    // Call once the frame's draws have been issued
+    inline void EndFrame() { m_Buffer.EndFrame(); }
+
+    inline void SetDebugName(const std::string& name) {
+        m_Buffer.SetDebugName(name);
+    }
+
+    inline unsigned int GetBinding() const { return m_Binding; }
+    inline unsigned int GetStride() const { return m_Stride; }
+    inline const StreamingBuffer::Stats& GetStats() const {
+        return m_Buffer.GetStats();
+    }
+};
@@ -1,8 +1,14 @@
 #include "VertexArray.h"
 
+#include <algorithm>
 #include <iostream>
+#include <utility>
 
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "IndexBuffer.h"
 #include "Renderer.h"
+#include "StreamingBuffer.h"
 #include "VertexBufferLayout.h"
 
 // Vertex array object is needed to bind vertex buffer to specific
@@ -15,25 +21,160 @@
 // GLCall(glGenVertexArrays(1, &vao));
 // GLCall(glBindVertexArray(vao));
 
-VertexArray::VertexArray() { GLCall(glGenVertexArrays(1, &m_RendererID)); }
-VertexArray::~VertexArray() { GLCall(glDeleteVertexArrays(1, &m_RendererID)); }
+// With direct state access (GL 4.5) the vertex format and the buffer it
+// reads from are set separately and by name:
+//   glVertexArrayAttribFormat   type, count and offset of an attribute
+//   glVertexArrayAttribBinding  which buffer binding the attribute reads
+//   glVertexArrayVertexBuffer   buffer, offset and stride of the binding
+// so nothing gets bound and switching buffers is the last call alone. The
+// 3.3 path does the same with binds and glVertexAttribPointer.
 
-void VertexArray::AddBuffer(const VertexBuffer &vb,
-                            const VertexBufferLayout &layout) {
-    Bind();
-    vb.Bind();
-    const auto &elements = layout.GetElements();
-    unsigned int offset = 0;
-    for (unsigned int i = 0; i < elements.size(); ++i) {
+VertexArray::VertexArray() : m_AttributeCount(0), m_BindingCount(0) {
+    if (GLHasDirectStateAccess()) {
+        GLCall(glCreateVertexArrays(1, &m_RendererID));
+    } else {
+        GLCall(glGenVertexArrays(1, &m_RendererID));
+    }
+}
+VertexArray::~VertexArray() {
+    DeletionQueue::Get().Push(GLObjectType::VertexArray, m_RendererID);
+}
+
+VertexArray::VertexArray(VertexArray &&other) noexcept
+    : m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_AttributeCount(other.m_AttributeCount),
+      m_BindingCount(other.m_BindingCount) {
+    std::copy(other.m_Bindings, other.m_Bindings + m_BindingCount,
+              m_Bindings);
+    std::copy(other.m_Formats, other.m_Formats + m_AttributeCount, m_Formats);
+}
+
+// Our old vertex array goes to other and is deleted along with it
+VertexArray &VertexArray::operator=(VertexArray &&other) noexcept {
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_AttributeCount, other.m_AttributeCount);
+    std::swap(m_BindingCount, other.m_BindingCount);
+    std::swap(m_Bindings, other.m_Bindings);
+    std::swap(m_Formats, other.m_Formats);
+    return *this;
+}
+
+unsigned int VertexArray::AddBuffer(const VertexBuffer &vb,
+                                    const VertexBufferLayout &layout) {
+    return AddBuffer(vb, layout, m_AttributeCount);
+}
+
+unsigned int VertexArray::AddBuffer(const VertexBuffer &vb,
+                                    const VertexBufferLayout &layout,
+                                    unsigned int firstAttribute) {
+    return SetAttributes(layout.GetElements().data(),
+                         layout.GetElements().size(), layout.GetStride(),
+                         firstAttribute, vb.GetRendererID());
+}
+
+unsigned int VertexArray::AddBuffer(const StreamingBuffer &sb,
+                                    const VertexBufferLayout &layout) {
+    return SetAttributes(layout.GetElements().data(),
+                         layout.GetElements().size(), layout.GetStride(),
+                         m_AttributeCount, sb.GetRendererID());
+}
+
+unsigned int VertexArray::SetAttributes(const VertexAttribute *elements,
+                                        unsigned int count,
+                                        unsigned int stride,
+                                        unsigned int firstAttribute,
+                                        unsigned int buffer) {
+    ASSERT(firstAttribute + count <= MaxAttributes);
+    ASSERT(m_BindingCount < MaxAttributes);
+
+    unsigned int binding = m_BindingCount++;
+    m_Bindings[binding] = {firstAttribute, count, stride};
+
+    bool dsa = GLHasDirectStateAccess();
+    if (dsa) {
+        GLCall(glVertexArrayVertexBuffer(m_RendererID, binding, buffer, 0,
+                                         stride));
+    } else {
+        Bind();
+        GLState::Get().BindBuffer(GL_ARRAY_BUFFER, buffer);
+    }
+
+    for (unsigned int i = 0; i < count; ++i) {
         const auto &element = elements[i];
-        GLCall(glEnableVertexAttribArray(i));
-        GLCall(glVertexAttribPointer(i, element.count, element.type,
-                                     element.normalized, layout.GetStride(),
-                                     reinterpret_cast<const void *>(offset)));
-        offset += element.count * VertexAttribute::GetSizeOfType(element.type);
+        unsigned int index = firstAttribute + i;
+        m_Formats[index] = {element.type, element.count, element.normalized,
+                            element.offset};
+
+        if (dsa) {
+            GLCall(glEnableVertexArrayAttrib(m_RendererID, index));
+            GLCall(glVertexArrayAttribFormat(m_RendererID, index,
+                                             element.count, element.type,
+                                             element.normalized,
+                                             element.offset));
+            GLCall(glVertexArrayAttribBinding(m_RendererID, index, binding));
+            continue;
+        }
+
+        GLCall(glEnableVertexAttribArray(index));
+        GLCall(glVertexAttribPointer(index, element.count, element.type,
+                                     element.normalized, stride,
+                                     reinterpret_cast<const void *>(
+                                         element.offset)));
+        if (element.divisor) {
+            GLCall(glVertexAttribDivisor(index, element.divisor));
+        }
+    }
+
+    // DSA sets the divisor per binding, attributes sharing a buffer have to
+    // share it too
+    if (dsa && count && elements[0].divisor) {
+        for (unsigned int i = 1; i < count; ++i)
+            ASSERT(elements[i].divisor == elements[0].divisor);
+        GLCall(glVertexArrayBindingDivisor(m_RendererID, binding,
+                                           elements[0].divisor));
+    }
+
+    m_AttributeCount =
+        std::max<unsigned int>(m_AttributeCount, firstAttribute + count);
+    return binding;
+}
+
+void VertexArray::SetBuffer(unsigned int binding, unsigned int buffer,
+                            unsigned int offset) {
+    ASSERT(binding < m_BindingCount);
+    const Binding &b = m_Bindings[binding];
+
+    if (GLHasDirectStateAccess()) {
+        GLCall(glVertexArrayVertexBuffer(m_RendererID, binding, buffer, offset,
+                                         b.Stride));
+        return;
+    }
+
+    Bind();
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, buffer);
+    for (unsigned int i = 0; i < b.AttributeCount; ++i) {
+        unsigned int index = b.FirstAttribute + i;
+        const AttributeFormat &format = m_Formats[index];
+        GLCall(glVertexAttribPointer(index, format.Count, format.Type,
+                                     format.Normalized, b.Stride,
+                                     reinterpret_cast<const void *>(
+                                         offset + format.Offset)));
     }
 }
 
-void VertexArray::Bind() const { GLCall(glBindVertexArray(m_RendererID)); }
+void VertexArray::SetIndexBuffer(const IndexBuffer &ib) {
+    if (GLHasDirectStateAccess()) {
+        GLCall(glVertexArrayElementBuffer(m_RendererID, ib.GetRendererID()));
+        GLState::Get().OnElementBuffer(m_RendererID, ib.GetRendererID());
+        return;
+    }
+
+    Bind();
+    ib.Bind();
+}
+
+void VertexArray::Bind() const {
+    GLState::Get().BindVertexArray(m_RendererID);
+}
 
-void VertexArray::Unbind() const { GLCall(glBindVertexArray(0)); }
+void VertexArray::Unbind() const { GLState::Get().BindVertexArray(0); }
@@ -2,18 +2,92 @@
 
 #include "VertexBuffer.h"
 
+class IndexBuffer;
+class StreamingBuffer;
 class VertexBufferLayout;
+struct VertexAttribute;
 
 class VertexArray {
+   public:
+    static const unsigned int MaxAttributes = 16;
+
    private:
+    // Where the attributes of one AddBuffer call read from
+    struct Binding {
+        unsigned int FirstAttribute;
+        unsigned int AttributeCount;
+        unsigned int Stride;
+    };
+
+    // Format of one attribute, the 3.3 path has to repeat it to re-point the
+    // attribute at another buffer
+    struct AttributeFormat {
+        unsigned int Type;
+        unsigned int Count;
+        unsigned char Normalized;
+        unsigned int Offset;
+    };
+
     unsigned int m_RendererID;
+    // Next free attribute index, buffers added later continue from here
+    unsigned int m_AttributeCount;
+    unsigned int m_BindingCount;
+    Binding m_Bindings[MaxAttributes];
+    AttributeFormat m_Formats[MaxAttributes];
 
    public:
     VertexArray();
     ~VertexArray();
 
-    void AddBuffer(const VertexBuffer &vb, const VertexBufferLayout &layout);
+    // Move-only, a copy would delete the GL object twice
+    VertexArray(const VertexArray &) = delete;
+    VertexArray &operator=(const VertexArray &) = delete;
+    VertexArray(VertexArray &&other) noexcept;
+    VertexArray &operator=(VertexArray &&other) noexcept;
+
+    // Attributes of the layout get consecutive indices after the ones
+    // already added, so a per-vertex buffer can be followed by a per-instance
+    // one. Returns the binding index to re-point with SetBuffer.
+    unsigned int AddBuffer(const VertexBuffer &vb,
+                           const VertexBufferLayout &layout);
+    // Same, but the first attribute of the layout goes to firstAttribute
+    unsigned int AddBuffer(const VertexBuffer &vb,
+                           const VertexBufferLayout &layout,
+                           unsigned int firstAttribute);
+    // Attributes read from the start of the streaming buffer, draws pick
+    // their allocation with a base vertex
+    unsigned int AddBuffer(const StreamingBuffer &sb,
+                           const VertexBufferLayout &layout);
+
+    // Same as above with a compile-time Layout (see VertexBufferLayout.h),
+    // works for a VertexBuffer or a StreamingBuffer
+    template <typename L, typename Buffer>
+    unsigned int AddBuffer(const Buffer &buffer) {
+        return SetAttributes(L::Elements.data(), L::Count, L::Stride,
+                             m_AttributeCount, buffer.GetRendererID());
+    }
+
+    // Makes the attributes of a binding read from another buffer with the
+    // same layout, starting offset bytes in. A single call with DSA, so one
+    // vertex array per vertex format can serve many buffers.
+    template <typename Buffer>
+    void SetBuffer(unsigned int binding, const Buffer &buffer,
+                   unsigned int offset = 0) {
+        SetBuffer(binding, buffer.GetRendererID(), offset);
+    }
+    void SetIndexBuffer(const IndexBuffer &ib);
 
     void Bind() const;
     void Unbind() const;
-};
\ No newline at end of file
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+
+   private:
+    // Points attributes at the buffer, through DSA when the context has it
+    unsigned int SetAttributes(const VertexAttribute *elements,
+                               unsigned int count, unsigned int stride,
+                               unsigned int firstAttribute,
+                               unsigned int buffer);
+    void SetBuffer(unsigned int binding, unsigned int buffer,
+                   unsigned int offset);
+};
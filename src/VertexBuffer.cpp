@@ -1,21 +1,81 @@
 #include "VertexBuffer.h"
 
+#include <utility>
+
+#include "DeletionQueue.h"
+#include "GLState.h"
+#include "GPUMemory.h"
 #include "Renderer.h"
 
 // Create one buffer in VRAM, bind it as GL_ARRAY_BUFFER, load data in it -
 // 24 bytes from positions GL_STATIC_DRAW - STATIC means we use it many
 // times, change once, and DRAW means we would DRAW it
 
-VertexBuffer::VertexBuffer(const void *data, unsigned int size) {
-    GLCall(glGenBuffers(1, &m_RendererID));
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
-    GLCall(glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW));
+VertexBuffer::VertexBuffer(const void *data, unsigned int size,
+                           BufferUsage usage)
+    : m_Capacity(size), m_Usage(usage) {
+    m_RendererID = BufferCreate();
+    BufferAllocate(m_RendererID, size, usage, data);
+    GPUMemory::Get().Track(MemoryCategory::VertexBuffer, m_RendererID, size);
+}
+
+// DYNAMIC means the contents are rewritten often, e.g. every frame
+VertexBuffer::VertexBuffer(unsigned int size, BufferUsage usage)
+    : m_Capacity(size), m_Usage(usage) {
+    m_RendererID = BufferCreate();
+    BufferAllocate(m_RendererID, size, usage);
+    GPUMemory::Get().Track(MemoryCategory::VertexBuffer, m_RendererID, size);
+}
+
+VertexBuffer::~VertexBuffer() {
+    GPUMemory::Get().Untrack(MemoryCategory::VertexBuffer, m_RendererID);
+    DeletionQueue::Get().Push(GLObjectType::Buffer, m_RendererID);
 }
 
-VertexBuffer::~VertexBuffer() { GLCall(glDeleteBuffers(1, &m_RendererID)); }
+VertexBuffer::VertexBuffer(VertexBuffer &&other) noexcept
+    : m_RendererID(std::exchange(other.m_RendererID, 0)),
+      m_Capacity(other.m_Capacity),
+      m_Usage(other.m_Usage) {}
+
+// Our old buffer goes to other and is deleted along with it
+VertexBuffer &VertexBuffer::operator=(VertexBuffer &&other) noexcept {
+    std::swap(m_RendererID, other.m_RendererID);
+    std::swap(m_Capacity, other.m_Capacity);
+    std::swap(m_Usage, other.m_Usage);
+    return *this;
+}
 
 void VertexBuffer::Bind() const {
-    GLCall(glBindBuffer(GL_ARRAY_BUFFER, m_RendererID));
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+}
+
+void VertexBuffer::Unbind() const {
+    GLState::Get().BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void VertexBuffer::SetData(const void *data, unsigned int size) {
+    // Nothing is kept, so growing costs no more than orphaning
+    if (size > m_Capacity) m_Capacity = GrowCapacity(m_Capacity, size);
+    BufferAllocate(m_RendererID, m_Capacity, m_Usage);
+    GPUMemory::Get().Track(MemoryCategory::VertexBuffer, m_RendererID,
+                           m_Capacity);
+    BufferWrite(m_RendererID, 0, size, data);
+}
+
+void VertexBuffer::Update(const void *data, unsigned int size,
+                          unsigned int offset) {
+    if (offset + size > m_Capacity)
+        Reserve(GrowCapacity(m_Capacity, offset + size));
+    BufferWrite(m_RendererID, offset, size, data);
+}
+
+void VertexBuffer::Reserve(unsigned int size) {
+    if (size <= m_Capacity) return;
+    BufferReallocate(m_RendererID, size, m_Usage, m_Capacity);
+    m_Capacity = size;
+    GPUMemory::Get().Track(MemoryCategory::VertexBuffer, m_RendererID, size);
 }
 
-void VertexBuffer::Unbind() const { GLCall(glBindBuffer(GL_ARRAY_BUFFER, 0)); }
\ No newline at end of file
+void VertexBuffer::SetDebugName(const std::string &name) {
+    GPUMemory::Get().SetName(MemoryCategory::VertexBuffer, m_RendererID, name);
+}
@@ -1,14 +1,46 @@
 #pragma once
 
+#include <string>
+
+#include "BufferUsage.h"
+
 class VertexBuffer
 {
 private:
     unsigned int m_RendererID;
+    // Bytes of storage, may be more than the data written so far
+    unsigned int m_Capacity;
+    BufferUsage m_Usage;
 
 public:
-    VertexBuffer(const void *data, unsigned int size);
+    VertexBuffer(const void *data, unsigned int size,
+                 BufferUsage usage = BufferUsage::Static);
+    // Allocates storage only, fill it later with SetData or Update
+    VertexBuffer(unsigned int size, BufferUsage usage = BufferUsage::Dynamic);
     ~VertexBuffer();
 
+    // Move-only, a copy would delete the GL object twice
+    VertexBuffer(const VertexBuffer &) = delete;
+    VertexBuffer &operator=(const VertexBuffer &) = delete;
+    VertexBuffer(VertexBuffer &&other) noexcept;
+    VertexBuffer &operator=(VertexBuffer &&other) noexcept;
+
     void Bind() const;
     void Unbind() const;
+
+    // Replaces the whole contents. The old storage is orphaned first, so
+    // this never waits for draws still reading the previous data.
+    void SetData(const void *data, unsigned int size);
+    // Writes size bytes at offset and keeps the rest, the buffer grows if
+    // they don't fit
+    void Update(const void *data, unsigned int size, unsigned int offset = 0);
+    // Grows the storage to at least size bytes, keeping the contents
+    void Reserve(unsigned int size);
+
+    // Name the buffer's memory is reported under, see GPUMemory
+    void SetDebugName(const std::string &name);
+
+    inline unsigned int GetRendererID() const { return m_RendererID; }
+    inline unsigned int GetCapacity() const { return m_Capacity; }
+    inline BufferUsage GetUsage() const { return m_Usage; }
 };
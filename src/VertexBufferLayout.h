@@ -1,31 +1,91 @@
 #pragma once
 
+#include <array>
 #include <vector>
 
 #include "Renderer.h"
+#include "VertexPacking.h"
 
 // Let OpenGL know what type our attributes are
 // Attribute id, amount of values in attribute (1...4), type itself, should
 // it be normalized or not, size of vertex, offset to attribute from vertex
 // start
+// Divisor 0 means the attribute advances per vertex, N means it advances
+// once every N instances (per-instance data for instanced draws)
+// Offset is stored rather than summed from counts since packed types like
+// GL_INT_2_10_10_10_REV fit all their components in one 4 byte value
 
 struct VertexAttribute {
     unsigned int type;
     unsigned int count;
     unsigned char normalized;
+    unsigned int divisor;
+    unsigned int offset;
+};
 
-    static unsigned int GetSizeOfType(unsigned int type) {
-        switch (type) {
-            case GL_FLOAT:
-                return 4;
-            case GL_UNSIGNED_INT:
-                return 4;
-            case GL_UNSIGNED_BYTE:
-                return 1;
-        }
-        ASSERT(false);
-        return 0;
-    }
+// What GL needs to know about a C++ type used as vertex attribute data.
+// Anything without a specialization below fails to compile.
+template <typename T>
+struct AttributeTraits {
+    static_assert(sizeof(T) == 0, "Unsupported vertex attribute type");
+};
+
+template <>
+struct AttributeTraits<float> {
+    static constexpr unsigned int Type = GL_FLOAT;
+    static constexpr unsigned char Normalized = GL_FALSE;
+    static constexpr unsigned int Size = 4;
+    static constexpr bool Packed = false;
+};
+
+template <>
+struct AttributeTraits<unsigned int> {
+    static constexpr unsigned int Type = GL_UNSIGNED_INT;
+    static constexpr unsigned char Normalized = GL_FALSE;
+    static constexpr unsigned int Size = 4;
+    static constexpr bool Packed = false;
+};
+
+// Bytes are colors far more often than small integers, read as [0, 1]
+template <>
+struct AttributeTraits<unsigned char> {
+    static constexpr unsigned int Type = GL_UNSIGNED_BYTE;
+    static constexpr unsigned char Normalized = GL_TRUE;
+    static constexpr unsigned int Size = 1;
+    static constexpr bool Packed = false;
+};
+
+template <>
+struct AttributeTraits<Half> {
+    static constexpr unsigned int Type = GL_HALF_FLOAT;
+    static constexpr unsigned char Normalized = GL_FALSE;
+    static constexpr unsigned int Size = 2;
+    static constexpr bool Packed = false;
+};
+
+template <>
+struct AttributeTraits<SNorm16> {
+    static constexpr unsigned int Type = GL_SHORT;
+    static constexpr unsigned char Normalized = GL_TRUE;
+    static constexpr unsigned int Size = 2;
+    static constexpr bool Packed = false;
+};
+
+template <>
+struct AttributeTraits<UNorm16> {
+    static constexpr unsigned int Type = GL_UNSIGNED_SHORT;
+    static constexpr unsigned char Normalized = GL_TRUE;
+    static constexpr unsigned int Size = 2;
+    static constexpr bool Packed = false;
+};
+
+// All four components share one 4 byte value, GL always takes 4
+template <>
+struct AttributeTraits<Packed2101010> {
+    static constexpr unsigned int Type = GL_INT_2_10_10_10_REV;
+    static constexpr unsigned char Normalized = GL_TRUE;
+    static constexpr unsigned int Size = 4;
+    static constexpr bool Packed = true;
 };
 
 class VertexBufferLayout {
@@ -36,8 +96,15 @@ class VertexBufferLayout {
    public:
     VertexBufferLayout() : m_Stride(0) {}
 
+    // For packed types count is the number of components the shader reads
     template <typename T>
-    void Push(unsigned int count);
+    void Push(unsigned int count, unsigned int divisor = 0) {
+        using Traits = AttributeTraits<T>;
+        if (Traits::Packed) ASSERT(count == 4);
+        m_Elements.push_back(
+            {Traits::Type, count, Traits::Normalized, divisor, m_Stride});
+        m_Stride += Traits::Packed ? Traits::Size : Traits::Size * count;
+    }
 
     inline const std::vector<VertexAttribute>& GetElements() const {
         return m_Elements;
@@ -45,26 +112,55 @@ class VertexBufferLayout {
     inline unsigned int GetStride() const { return m_Stride; }
 };
 
-template <typename T>
-inline void VertexBufferLayout::Push(unsigned int count) {
-    // static_assert(false);
-    count++;
-}
+// One attribute of a compile-time Layout, Count components of T
+template <typename T, unsigned int Count, unsigned int Divisor = 0>
+struct Attribute {
+    static_assert(Count >= 1 && Count <= 4, "Attributes have 1 to 4 components");
+    static_assert(!AttributeTraits<T>::Packed || Count == 4,
+                  "Packed attributes always have 4 components");
 
-template <>
-inline void VertexBufferLayout::Push<float>(unsigned int count) {
-    m_Elements.push_back({GL_FLOAT, count, GL_FALSE});
-    m_Stride += VertexAttribute::GetSizeOfType(GL_FLOAT) * count;
-}
+    static constexpr unsigned int Size =
+        AttributeTraits<T>::Packed ? AttributeTraits<T>::Size
+                                   : AttributeTraits<T>::Size * Count;
 
-template <>
-inline void VertexBufferLayout::Push<unsigned int>(unsigned int count) {
-    m_Elements.push_back({GL_UNSIGNED_INT, count, GL_FALSE});
-    m_Stride += VertexAttribute::GetSizeOfType(GL_UNSIGNED_INT) * count;
-}
+    static constexpr VertexAttribute Describe(unsigned int offset) {
+        return {AttributeTraits<T>::Type, Count,
+                AttributeTraits<T>::Normalized, Divisor, offset};
+    }
+};
 
-template <>
-inline void VertexBufferLayout::Push<unsigned char>(unsigned int count) {
-    m_Elements.push_back({GL_UNSIGNED_BYTE, count, GL_TRUE});
-    m_Stride += VertexAttribute::GetSizeOfType(GL_UNSIGNED_BYTE) * count;
-}
\ No newline at end of file
+using Float = Attribute<float, 1>;
+using Vec2 = Attribute<float, 2>;
+using Vec3 = Attribute<float, 3>;
+using Vec4 = Attribute<float, 4>;
+using RGBA8 = Attribute<unsigned char, 4>;
+using Half2 = Attribute<Half, 2>;
+using Half4 = Attribute<Half, 4>;
+using UNorm16x2 = Attribute<UNorm16, 2>;
+using UNorm16x4 = Attribute<UNorm16, 4>;
+using SNorm16x2 = Attribute<SNorm16, 2>;
+using SNorm16x4 = Attribute<SNorm16, 4>;
+using Normal2101010 = Attribute<Packed2101010, 4>;
+
+// A vertex layout known at compile time, declared next to its vertex struct
+//   struct Vertex { glm::vec2 Position; glm::vec2 TexCoord; uint32_t Color; };
+//   using VertexLayout = Layout<Vec2, Vec2, RGBA8>;
+//   static_assert(VertexLayout::Stride == sizeof(Vertex));
+// and used with VertexArray::AddBuffer<VertexLayout>(vb). Stride and offsets
+// are constants, nothing is allocated.
+template <typename... Attributes>
+struct Layout {
+    static constexpr unsigned int Count = sizeof...(Attributes);
+    static constexpr unsigned int Stride = (Attributes::Size + ... + 0);
+
+    static constexpr std::array<VertexAttribute, Count> Describe() {
+        std::array<VertexAttribute, Count> elements{};
+        unsigned int offset = 0, i = 0;
+        ((elements[i++] = Attributes::Describe(offset),
+          offset += Attributes::Size),
+         ...);
+        return elements;
+    }
+
+    static constexpr std::array<VertexAttribute, Count> Elements = Describe();
+};
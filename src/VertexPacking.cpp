@@ -0,0 +1,61 @@
+#include "VertexPacking.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Renderer.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/packing.hpp"
+
+float QuantizeHalf(const float* input, unsigned int count, Half* output) {
+    float error = 0.0f;
+    for (unsigned int i = 0; i < count; ++i) {
+        output[i].Bits = glm::packHalf1x16(input[i]);
+        error = std::max(
+            error, std::abs(glm::unpackHalf1x16(output[i].Bits) - input[i]));
+    }
+    return error;
+}
+
+float QuantizeSNorm16(const float* input, unsigned int count,
+                      SNorm16* output) {
+    float error = 0.0f;
+    for (unsigned int i = 0; i < count; ++i) {
+        uint16_t bits = glm::packSnorm1x16(input[i]);
+        output[i].Bits = (int16_t)bits;
+        error = std::max(error,
+                         std::abs(glm::unpackSnorm1x16(bits) - input[i]));
+    }
+    return error;
+}
+
+float QuantizeUNorm16(const float* input, unsigned int count, UNorm16* output,
+                      float min, float max) {
+    ASSERT(max > min);
+    float range = max - min;
+
+    float error = 0.0f;
+    for (unsigned int i = 0; i < count; ++i) {
+        output[i].Bits = glm::packUnorm1x16((input[i] - min) / range);
+        float decoded = min + glm::unpackUnorm1x16(output[i].Bits) * range;
+        error = std::max(error, std::abs(decoded - input[i]));
+    }
+    return error;
+}
+
+float QuantizeSNorm2101010(const float* input, unsigned int count,
+                           unsigned int components, Packed2101010* output) {
+    ASSERT(components == 3 || components == 4);
+
+    float error = 0.0f;
+    for (unsigned int i = 0; i < count; ++i) {
+        const float* v = input + i * components;
+        glm::vec4 value(v[0], v[1], v[2], components == 4 ? v[3] : 0.0f);
+        output[i].Bits = glm::packSnorm3x10_1x2(value);
+
+        glm::vec4 decoded = glm::unpackSnorm3x10_1x2(output[i].Bits);
+        for (unsigned int c = 0; c < components; ++c)
+            error = std::max(error, std::abs(decoded[c] - value[c]));
+    }
+    return error;
+}
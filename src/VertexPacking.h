@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+// Storage types for compact vertex attributes. Each wraps the raw bits so
+// VertexBufferLayout::Push can tell them apart (half floats and unsigned
+// normalized shorts are both 16-bit unsigned integers underneath).
+
+// 16-bit float, GL_HALF_FLOAT. About 3 significant digits, fine for texture
+// coordinates and colors, too coarse for positions of large meshes.
+struct Half {
+    uint16_t Bits;
+};
+
+// [-1, 1] in 16 bits, GL_SHORT normalized
+struct SNorm16 {
+    int16_t Bits;
+};
+
+// [0, 1] in 16 bits, GL_UNSIGNED_SHORT normalized. With a per-mesh offset and
+// scale (see QuantizeUNorm16) a good format for positions.
+struct UNorm16 {
+    uint16_t Bits;
+};
+
+// x, y, z in [-1, 1] with 10 bits each and a 2-bit w, all in 4 bytes,
+// GL_INT_2_10_10_10_REV normalized. Meant for normals and tangents.
+// Always a 4 component attribute.
+struct Packed2101010 {
+    uint32_t Bits;
+};
+
+// Converters from float data. Each writes count values and returns the
+// largest absolute error of the result, measured by decoding it again.
+// Worst cases: half 2^-11 relative, snorm16 1/65534, unorm16
+// (max - min)/131070, 2_10_10_10 xyz 1/1022.
+
+float QuantizeHalf(const float* input, unsigned int count, Half* output);
+float QuantizeSNorm16(const float* input, unsigned int count, SNorm16* output);
+// Maps [min, max] onto [0, 1], the shader gets back min + value * (max - min)
+// so fold that into the model matrix
+float QuantizeUNorm16(const float* input, unsigned int count, UNorm16* output,
+                      float min = 0.0f, float max = 1.0f);
+// count vectors of components (3 or 4) floats each, a missing w becomes 0
+float QuantizeSNorm2101010(const float* input, unsigned int count,
+                           unsigned int components, Packed2101010* output);